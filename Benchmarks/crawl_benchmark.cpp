@@ -0,0 +1,167 @@
+// Crawler throughput benchmark against a local replay server, no network.
+//
+//   g++ -std=c++17 -O2 -I.. -o crawl_benchmark crawl_benchmark.cpp -lcurl -lpthread -lz
+//   ./crawl_benchmark [--corpus synthetic|<store.warc.gz>|<dir>] [--pages N] [--vocabulary N]
+//                     [--latency ms] [--jitter ms] [--bandwidth KB/s]
+//                     [--errors rate] [--resets rate]
+//                     [--fetch-threads N] [--parse-threads N] [--connections N] [--verbose]
+//
+// Reports pages/sec, bytes/sec, per-stage latency and CPU time per page.
+#include "replay_server.h"
+#include "synthetic_corpus.h"
+#include "../Crawler/crawl_pipeline.h"
+#include "../Metrics/memory_report.h"
+#include <curl/curl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+static double cpuSeconds() {
+    rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+}
+
+static void printStage(const char* name, const CrawlPipeline::StageStats& stage) {
+    std::cout << "  " << std::left << std::setw(6) << name << std::right
+              << " n=" << std::setw(6) << stage.processed
+              << "  avg " << std::setw(8) << stage.avgMillis() << " ms"
+              << "  p50 <" << std::setw(8) << stage.percentileMillis(0.50) << " ms"
+              << "  p99 <" << std::setw(8) << stage.percentileMillis(0.99) << " ms\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string corpus = "synthetic";
+    int maxPages = 2000;
+    int fetchThreads = 16, parseThreads = 4, connections = 8;
+    size_t vocabulary = 2000;                        // Every indexed term costs a 10007-bucket HashMap
+    bool verbose = false;
+    ReplayServer::Config serverConfig;
+    serverConfig.robotsTxt = "User-agent: *\nDisallow:\n";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() { return i + 1 < argc ? std::string(argv[++i]) : std::string(); };
+        if (arg == "--corpus") corpus = value();
+        else if (arg == "--pages") maxPages = std::atoi(value().c_str());
+        else if (arg == "--vocabulary") vocabulary = std::strtoull(value().c_str(), nullptr, 10);
+        else if (arg == "--latency") serverConfig.latency = std::chrono::milliseconds(std::atoi(value().c_str()));
+        else if (arg == "--jitter") serverConfig.jitter = std::chrono::milliseconds(std::atoi(value().c_str()));
+        else if (arg == "--bandwidth") serverConfig.bandwidth = std::strtoull(value().c_str(), nullptr, 10) * 1024;
+        else if (arg == "--errors") serverConfig.errorRate = std::atof(value().c_str());
+        else if (arg == "--resets") serverConfig.resetRate = std::atof(value().c_str());
+        else if (arg == "--fetch-threads") fetchThreads = std::atoi(value().c_str());
+        else if (arg == "--parse-threads") parseThreads = std::atoi(value().c_str());
+        else if (arg == "--connections") connections = std::atoi(value().c_str());
+        else if (arg == "--verbose") verbose = true;
+        else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return 1;
+        }
+    }
+
+    curl_global_init(CURL_GLOBAL_ALL);
+    std::unique_ptr<SyntheticCorpus> synthetic;
+    ReplayServer server(serverConfig);
+    std::string seedPath;
+    if (corpus == "synthetic") {
+        SyntheticCorpus::Config corpusConfig;
+        corpusConfig.pages = static_cast<size_t>(maxPages) * 2;
+        corpusConfig.vocabulary = vocabulary;
+        synthetic.reset(new SyntheticCorpus(corpusConfig));
+        server.setGenerator([&synthetic](const std::string& path, std::string& body) {
+            return synthetic->render(path, body);
+        });
+        seedPath = synthetic->path(synthetic->size() - 1);   // Newest page: most outlinks to established ones
+    } else {
+        struct stat st;
+        bool isDir = ::stat(corpus.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+        size_t loaded = isDir ? server.loadDirectory(corpus, LocalUrlMapper()) : server.loadStore(corpus);
+        if (loaded == 0) {
+            std::cerr << "No pages in " << corpus << "\n";
+            return 1;
+        }
+        // Seed with the first recorded page
+        StoredPage first;
+        if (isDir) DirectorySource(corpus, LocalUrlMapper()).next(first);
+        else PageStoreReader(corpus).next(first);
+        seedPath = ReplayServer::pathOf(first.url);
+    }
+    if (!server.start()) return 1;
+
+    CrawlPipeline::Config config;
+    config.maxPages = maxPages;
+    config.fetchThreads = fetchThreads;
+    config.parseThreads = parseThreads;
+    config.indexThreads = 1;
+    config.politeness.defaultDelay = std::chrono::milliseconds(0);
+    config.politeness.maxConnectionsPerHost = connections;
+    config.fetch.maxConnectionsPerHost = connections;
+    config.linkFilter = UrlFilter();
+    config.linkFilter.addRule(UrlFilter::INCLUDE_PREFIX, server.baseUrl() + "/");
+
+    std::cout << "[Bench] " << (synthetic ? synthetic->size() : server.pageCount()) << " pages on " << server.baseUrl()
+              << " | latency " << serverConfig.latency.count() << "+" << serverConfig.jitter.count() << " ms"
+              << " | bandwidth " << (serverConfig.bandwidth ? std::to_string(serverConfig.bandwidth / 1024) + " KB/s" : "unlimited")
+              << " | errors " << serverConfig.errorRate << " resets " << serverConfig.resetRate << "\n";
+    std::cout << "[Bench] " << maxPages << " pages, " << fetchThreads << " fetch / " << parseThreads
+              << " parse threads, " << connections << " connections\n";
+
+    Trie trie;
+    Graph graph;
+    InvertedIndex index;
+    std::ofstream visited("/dev/null");
+    if (!verbose) Logger::instance().setLevel(LogLevel::Warn);   // Per-page log lines would dominate the profile
+
+    double cpuStart = cpuSeconds();
+    auto wallStart = std::chrono::steady_clock::now();
+    {
+        CrawlPipeline pipeline(config, index, trie, graph, visited);
+        pipeline.seed(server.baseUrl() + seedPath);
+        pipeline.start();
+        int idleChecks = 0;
+        while (pipeline.isCrawling() && pipeline.processed() < maxPages && idleChecks < 2) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            idleChecks = pipeline.idle() ? idleChecks + 1 : 0;
+        }
+        pipeline.stop();
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+        double cpu = cpuSeconds() - cpuStart;
+        Logger::instance().flush();
+
+        size_t pages = pipeline.indexed();
+        const auto& served = server.stats();
+        std::cout << std::fixed << std::setprecision(2);
+        if (idleChecks >= 2) std::cout << "[Bench] Frontier ran dry before " << maxPages << " pages\n";
+        std::cout << "[Bench] " << pages << " pages in " << wall << " s\n"
+                  << "  throughput " << pages / wall << " pages/s, "
+                  << pipeline.bytesDownloaded() / 1e6 / wall << " MB/s ("
+                  << pipeline.bytesDownloaded() / 1e6 << " MB)\n"
+                  << "  cpu " << cpu << " s total, " << (pages ? cpu * 1000.0 / pages : 0.0) << " ms/page\n"
+                  << "  server " << served.requests << " requests, " << served.notFound << " 404, "
+                  << served.errors << " injected 503, " << served.resets << " resets, "
+                  << served.bytesSent / 1e6 << " MB sent\n";
+        printStage("fetch", pipeline.fetchStage());
+        printStage("parse", pipeline.parseStage());
+        printStage("index", pipeline.indexStage());
+
+        MemoryReport memory;
+        memory.add("index.postings", index.postingsMemory());
+        memory.add("index.doc_lengths", index.docLengthMemory());
+        memory.add("trie", trie.memoryUsage());
+        memory.add("graph", graph.memoryUsage());
+        memory.add("frontier", pipeline.frontierMemory());
+        memory.setDocuments(pages);
+        memory.print(std::cout, "  memory");
+    }
+    server.stop();
+    curl_global_cleanup();
+    return 0;
+}
@@ -0,0 +1,83 @@
+#ifndef HDR_HISTOGRAM_H
+#define HDR_HISTOGRAM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// High dynamic range histogram (the HdrHistogram layout): values up to 2^63 are
+// kept with 3 significant decimal digits by splitting every power of two into
+// 1024 linear sub-buckets. Recording is two shifts and an increment, memory is
+// fixed (~440 KB), and percentiles are exact to within 0.1%. One histogram per
+// thread, merged at the end; no locking inside.
+class HdrHistogram {
+private:
+    static const int SUB_BITS = 11;                          // 2048 sub-buckets -> 3 significant digits
+    static const int64_t SUB_COUNT = int64_t(1) << SUB_BITS;
+    static const int64_t HALF_COUNT = SUB_COUNT / 2;
+    static const int BUCKETS = 64 - SUB_BITS + 1;
+
+    std::vector<uint64_t> counts;
+    uint64_t total = 0;
+    int64_t minValue = INT64_MAX;
+    int64_t maxValue = 0;
+    long double sum = 0;
+
+    static int bucketOf(int64_t v) {
+        return std::max(0, 63 - __builtin_clzll(static_cast<uint64_t>(v) | 1) - (SUB_BITS - 1));
+    }
+
+    static size_t indexOf(int64_t v) {
+        int bucket = bucketOf(v);
+        int64_t sub = v >> bucket;                           // [1024, 2048) above bucket 0
+        return bucket == 0 ? static_cast<size_t>(sub) : static_cast<size_t>(bucket * HALF_COUNT + sub);
+    }
+
+    // Largest value that lands in the same slot as index `i`
+    static int64_t highestEquivalent(size_t i) {
+        if (i < static_cast<size_t>(SUB_COUNT)) return static_cast<int64_t>(i);
+        int bucket = static_cast<int>(i / HALF_COUNT) - 1;
+        int64_t sub = static_cast<int64_t>(i % HALF_COUNT) + HALF_COUNT;
+        return ((sub + 1) << bucket) - 1;
+    }
+
+public:
+    HdrHistogram() : counts(static_cast<size_t>(BUCKETS + 1) * HALF_COUNT, 0) {}
+
+    void record(int64_t value) {
+        if (value < 0) value = 0;
+        counts[indexOf(value)]++;
+        total++;
+        sum += value;
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+
+    void merge(const HdrHistogram& other) {
+        for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+        total += other.total;
+        sum += other.sum;
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+
+    // Value at quantile q (0..1): the smallest recorded slot covering q of the samples
+    int64_t percentile(double q) const {
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * total + 0.5);
+        if (rank < 1) rank = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) return std::min(highestEquivalent(i), maxValue);
+        }
+        return maxValue;
+    }
+
+    uint64_t count() const { return total; }
+    int64_t min() const { return total ? minValue : 0; }
+    int64_t max() const { return maxValue; }
+    double mean() const { return total ? static_cast<double>(sum / total) : 0.0; }
+};
+
+#endif
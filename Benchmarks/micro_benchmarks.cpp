@@ -0,0 +1,358 @@
+// Microbenchmarks for the core data structures and kernels (Google Benchmark).
+//
+//   g++ -std=c++17 -O2 -I.. -o micro_benchmarks micro_benchmarks.cpp -lbenchmark -lpthread -lz
+//   ./micro_benchmarks --benchmark_format=json --benchmark_out=baseline.json
+//   ./micro_benchmarks --benchmark_filter='HashMap|Trie'
+//
+// Fixtures are synthetic pages (Zipf vocabulary, power-law links, see
+// synthetic_corpus.h). Set MICROBENCH_PAGES=<store.warc.gz> to run the HTML
+// kernels on crawled pages instead. Compare two runs with Google Benchmark's
+// tools/compare.py benchmarks baseline.json new.json. Hardware counters per
+// iteration are added where perf_event_open is permitted.
+#include "synthetic_corpus.h"
+#include "../Crawler/link_parser.h"
+#include "../Data_Structures/graph.h"
+#include "../Data_Structures/hashmap.h"
+#include "../Data_Structures/hashset.h"
+#include "../Data_Structures/heap.h"
+#include "../Data_Structures/trie.h"
+#include "../Indexer/inverted_index.h"
+#include "../Metrics/perf_counters.h"
+#include "../Ranker/ranker.h"
+#include "../Scraper/scraper.h"
+#include "../Sorter/sorter.h"
+#include "../Storage/page_store.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Inputs shared by all benchmarks, built once on first use
+class Fixtures {
+private:
+    SyntheticCorpus corpus;
+
+    static SyntheticCorpus::Config corpusConfig() {
+        SyntheticCorpus::Config c;
+        c.pages = 5000;
+        c.vocabulary = 1000;                         // Keeps the InvertedIndex fixture (10007 buckets/term) small
+        return c;
+    }
+
+    Fixtures() : corpus(corpusConfig()) {
+        const char* store = std::getenv("MICROBENCH_PAGES");
+        if (store) {
+            PageStoreReader reader(store);
+            StoredPage page;
+            while (pages.size() < 200 && reader.next(page)) {
+                pages.push_back(std::move(page.body));
+                pageUrls.push_back(std::move(page.url));
+            }
+        }
+        if (pages.empty()) {
+            for (size_t i = 0; i < 200; ++i) {
+                pages.push_back(corpus.html(i));
+                pageUrls.push_back(corpus.url(i));
+            }
+        }
+
+        for (size_t i = 0; i < corpus.size(); ++i) urls.push_back(corpus.url(i));
+        std::mt19937_64 rng(7);
+        for (int i = 0; i < 20000; ++i) tokens.push_back(SyntheticCorpus::word(corpus.sampleRank(rng)));
+
+        // Term frequencies of the fixture pages: many ties, as in a real index
+        std::unordered_map<std::string, int> counts;
+        for (const auto& html : pages) {
+            for (const auto& w : Scraper::tokenize(Scraper::extractText(html))) counts[w]++;
+        }
+        for (const auto& c : counts) frequencies.emplace_back(c.first, c.second);
+    }
+
+public:
+    std::vector<std::string> pages;                  // Raw HTML
+    std::vector<std::string> pageUrls;
+    std::vector<std::string> urls;                   // 5000 distinct URLs
+    std::vector<std::string> tokens;                 // Zipf-distributed word stream
+    std::vector<std::pair<std::string, int>> frequencies;
+
+    static Fixtures& get() {
+        static Fixtures fixtures;
+        return fixtures;
+    }
+
+    const SyntheticCorpus& web() const { return corpus; }
+
+    // First `n` URLs of the corpus, repeated with a suffix past 5000
+    std::vector<std::string> keys(size_t n) const {
+        std::vector<std::string> out;
+        out.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            out.push_back(i < urls.size() ? urls[i] : urls[i % urls.size()] + "?" + std::to_string(i));
+        }
+        return out;
+    }
+};
+
+// perf_event_open counters over the benchmark loop, reported per iteration
+// (cycles, instructions, ipc, cache / branch misses, page faults, whichever the
+// machine allows). Setup inside PauseTiming() is counted too.
+class PerfRun {
+private:
+    benchmark::State& state;
+    PerfCounters::Sample before;
+    bool ok;
+
+public:
+    explicit PerfRun(benchmark::State& s) : state(s), ok(PerfCounters::forThread().read(before)) {}
+
+    ~PerfRun() {
+        PerfCounters::Sample after;
+        if (!ok || !PerfCounters::forThread().read(after)) return;
+        int64_t delta[PerfCounters::EVENT_COUNT];
+        for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e) {
+            delta[e] = (before.values[e] < 0 || after.values[e] < 0) ? -1 : after.values[e] - before.values[e];
+            if (delta[e] >= 0) {
+                state.counters[PerfCounters::name(e)] =
+                    benchmark::Counter(static_cast<double>(delta[e]), benchmark::Counter::kAvgIterations);
+            }
+        }
+        if (delta[PerfCounters::CYCLES] > 0 && delta[PerfCounters::INSTRUCTIONS] >= 0) {
+            state.counters["ipc"] = static_cast<double>(delta[PerfCounters::INSTRUCTIONS]) / delta[PerfCounters::CYCLES];
+        }
+    }
+};
+
+static void pageBytes(benchmark::State& state, const std::vector<std::string>& pages) {
+    size_t bytes = 0;
+    for (const auto& p : pages) bytes += p.size();
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * pages.size()));
+}
+
+// ── HashMap / HashSet ──
+
+static void BM_HashMapInsert(benchmark::State& state) {
+    auto keys = Fixtures::get().keys(state.range(0));
+    PerfRun perf(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unique_ptr<HashMap<int>> map(new HashMap<int>());   // 10007 buckets: too big for the stack
+        state.ResumeTiming();
+        for (size_t i = 0; i < keys.size(); ++i) map->put(keys[i], static_cast<int>(i));
+        benchmark::DoNotOptimize(map.get());
+        state.PauseTiming();
+        map.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_HashMapInsert)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_HashMapLookup(benchmark::State& state) {
+    auto keys = Fixtures::get().keys(state.range(0));
+    std::unique_ptr<HashMap<int>> map(new HashMap<int>());
+    for (size_t i = 0; i < keys.size(); ++i) map->put(keys[i], static_cast<int>(i));
+    std::mt19937_64 rng(1);
+    std::vector<size_t> order(4096);
+    for (auto& o : order) o = rng() % keys.size();
+    size_t i = 0;
+    PerfRun perf(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map->get(keys[order[i++ & 4095]]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HashMapLookup)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_HashSetInsert(benchmark::State& state) {
+    auto keys = Fixtures::get().keys(state.range(0));
+    PerfRun perf(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unique_ptr<HashSet> set(new HashSet());
+        state.ResumeTiming();
+        for (const auto& k : keys) set->insert(k);
+        benchmark::DoNotOptimize(set.get());
+        state.PauseTiming();
+        set.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_HashSetInsert)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_HashSetContains(benchmark::State& state) {
+    auto keys = Fixtures::get().keys(state.range(0));
+    std::unique_ptr<HashSet> set(new HashSet());
+    for (size_t i = 0; i < keys.size(); i += 2) set->insert(keys[i]);   // Half hits, half misses
+    size_t i = 0;
+    PerfRun perf(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(set->contains(keys[i++ % keys.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HashSetContains)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// ── Trie ──
+
+static void BM_TrieInsert(benchmark::State& state) {
+    const auto& tokens = Fixtures::get().tokens;
+    PerfRun perf(state);
+    for (auto _ : state) {
+        Trie trie;
+        for (const auto& t : tokens) trie.insert(t);
+        benchmark::DoNotOptimize(&trie);
+    }
+    state.SetItemsProcessed(state.iterations() * tokens.size());
+}
+BENCHMARK(BM_TrieInsert);
+
+static void BM_TrieSuggestions(benchmark::State& state) {
+    const auto& tokens = Fixtures::get().tokens;
+    Trie trie;
+    for (const auto& t : tokens) trie.insert(t);
+    size_t prefixLen = static_cast<size_t>(state.range(0));
+    size_t i = 0;
+    PerfRun perf(state);
+    for (auto _ : state) {
+        const std::string& t = tokens[i++ % tokens.size()];
+        benchmark::DoNotOptimize(trie.getSuggestions(t.substr(0, std::min(prefixLen, t.size())), 10));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TrieSuggestions)->Arg(1)->Arg(2)->Arg(4);
+
+// ── Sorter / MaxHeap ──
+
+// Recursive Lomuto partition: ties (common in term counts) make it quadratic,
+// so sizes stay where the recursion depth is safe
+static void BM_QuickSortFrequencies(benchmark::State& state) {
+    const auto& all = Fixtures::get().frequencies;
+    size_t n = std::min<size_t>(state.range(0), all.size());
+    std::vector<std::pair<std::string, int>> input(all.begin(), all.begin() + n);
+    std::shuffle(input.begin(), input.end(), std::mt19937_64(3));
+    PerfRun perf(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto v = input;
+        state.ResumeTiming();
+        Sorter::quickSort(v, 0, static_cast<int>(v.size()) - 1);
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_QuickSortFrequencies)->Arg(100)->Arg(500)->Arg(1000);
+
+static void BM_QuickSortDistinct(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(0));
+    std::vector<std::pair<std::string, int>> input;
+    for (size_t i = 0; i < n; ++i) input.emplace_back("w" + std::to_string(i), static_cast<int>(i));
+    std::shuffle(input.begin(), input.end(), std::mt19937_64(4));
+    PerfRun perf(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto v = input;
+        state.ResumeTiming();
+        Sorter::quickSort(v, 0, static_cast<int>(v.size()) - 1);
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_QuickSortDistinct)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_HeapTopK(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(0));
+    const auto& urls = Fixtures::get().urls;
+    std::mt19937_64 rng(5);
+    std::exponential_distribution<double> scores(1.0);
+    std::vector<Ranker::ScoredDoc> candidates;
+    for (size_t i = 0; i < n; ++i) candidates.emplace_back(scores(rng), urls[i % urls.size()]);
+    PerfRun perf(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Ranker::getTopK(candidates, 20));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_HeapTopK)->Arg(100)->Arg(10000)->Arg(100000);
+
+// ── Scraper / link extraction ──
+
+static void BM_ExtractText(benchmark::State& state) {
+    const auto& pages = Fixtures::get().pages;
+    PerfRun perf(state);
+    for (auto _ : state) {
+        for (const auto& p : pages) benchmark::DoNotOptimize(Scraper::extractText(p));
+    }
+    pageBytes(state, pages);
+}
+BENCHMARK(BM_ExtractText);
+
+static void BM_Tokenize(benchmark::State& state) {
+    std::vector<std::string> texts;
+    for (const auto& p : Fixtures::get().pages) texts.push_back(Scraper::extractText(p));
+    PerfRun perf(state);
+    for (auto _ : state) {
+        for (const auto& t : texts) benchmark::DoNotOptimize(Scraper::tokenize(t));
+    }
+    pageBytes(state, texts);
+}
+BENCHMARK(BM_Tokenize);
+
+static void BM_ExtractLinks(benchmark::State& state) {
+    const auto& f = Fixtures::get();
+    PerfRun perf(state);
+    for (auto _ : state) {
+        for (size_t i = 0; i < f.pages.size(); ++i) benchmark::DoNotOptimize(extractLinks(f.pages[i], f.pageUrls[i]));
+    }
+    pageBytes(state, f.pages);
+}
+BENCHMARK(BM_ExtractLinks);
+
+// ── Ranker ──
+
+static void BM_ComputeTFIDF(benchmark::State& state) {
+    const auto& f = Fixtures::get();
+    static InvertedIndex index;                      // Built once; HashMap<HashMap<int>> is heavy to rebuild
+    static std::vector<std::pair<std::string, std::string>> pairs;
+    if (pairs.empty()) {
+        for (size_t i = 0; i < f.pages.size(); ++i) {
+            auto words = Scraper::tokenize(Scraper::extractText(f.pages[i]));
+            for (const auto& w : words) index.add(w, f.pageUrls[i]);
+            for (size_t k = 0; k < words.size() && pairs.size() < 1024; k += 37) pairs.emplace_back(words[k], f.pageUrls[i]);
+        }
+    }
+    size_t i = 0;
+    PerfRun perf(state);
+    for (auto _ : state) {
+        const auto& p = pairs[i++ % pairs.size()];
+        benchmark::DoNotOptimize(Ranker::computeTFIDF(index, p.first, p.second));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["docs"] = static_cast<double>(index.getDocCount());
+}
+BENCHMARK(BM_ComputeTFIDF);
+
+static void BM_PageRank(benchmark::State& state) {
+    const auto& web = Fixtures::get().web();
+    size_t n = static_cast<size_t>(state.range(0));
+    Graph graph;
+    for (size_t i = 0; i < n; ++i) {
+        for (uint32_t t : web.links(i)) {
+            if (t < n) graph.addEdge(web.url(i), web.url(t));
+        }
+    }
+    PerfRun perf(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Ranker::computePageRank(graph, 20, 0.85));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_PageRank)->Arg(500)->Arg(2000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
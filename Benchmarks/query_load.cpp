@@ -0,0 +1,242 @@
+// Open-loop load generator for /api/search.
+//
+//   g++ -std=c++17 -O2 -I.. -o query_load query_load.cpp -lcurl -lpthread
+//   ./query_load [--url http://127.0.0.1:8080] [--rate qps] [--duration s] [--warmup s]
+//                [--connections N] [--suggest-ratio 0.3] [--zipf s]
+//                [--log queries.txt | --index Indexer/inverted_index.txt] [--seed N]
+//
+// Requests are sent on a fixed schedule (Poisson arrivals at --rate) whether or
+// not earlier ones have returned, and latency is measured from the scheduled
+// send time. A slow server therefore shows up as queueing in the percentiles
+// instead of silently lowering the offered load (no coordinated omission).
+//
+// Query log: one query per line; "suggest:<text>" lines are autocomplete calls.
+// Without a log, queries are 1-3 terms drawn Zipf-style from the index's terms,
+// ranked by document frequency, and suggestions are 1-4 letter prefixes.
+#include "hdr_histogram.h"
+#include <curl/curl.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct Request {
+    bool suggest = false;
+    std::string text;
+};
+
+struct WorkerResult {
+    HdrHistogram search, suggest;                    // Microseconds
+    uint64_t errors = 0;
+    uint64_t bytes = 0;
+};
+
+static size_t discard(char*, size_t size, size_t nmemb, void* userdata) {
+    *static_cast<uint64_t*>(userdata) += size * nmemb;
+    return size * nmemb;
+}
+
+// Words of the saved index ("word|url;url"), most documents first
+static std::vector<std::string> indexTerms(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<std::pair<size_t, std::string>> ranked;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t sep = line.find('|');
+        if (sep == std::string::npos || sep == 0) continue;
+        ranked.emplace_back(std::count(line.begin() + sep, line.end(), ';') + 1, line.substr(0, sep));
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    std::vector<std::string> terms;
+    for (auto& r : ranked) terms.push_back(std::move(r.second));
+    return terms;
+}
+
+static std::vector<Request> synthesize(const std::vector<std::string>& terms, size_t count, double zipf,
+                                       double suggestRatio, uint64_t seed) {
+    std::vector<double> cdf(terms.size());
+    double sum = 0.0;
+    for (size_t r = 0; r < terms.size(); ++r) cdf[r] = (sum += 1.0 / std::pow(r + 1.0, zipf));
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    auto term = [&]() -> const std::string& {
+        size_t r = std::lower_bound(cdf.begin(), cdf.end(), unit(rng) * sum) - cdf.begin();
+        return terms[std::min(r, terms.size() - 1)];
+    };
+
+    std::vector<Request> requests(count);
+    for (auto& req : requests) {
+        req.suggest = unit(rng) < suggestRatio;
+        if (req.suggest) {
+            const std::string& t = term();
+            req.text = t.substr(0, std::min<size_t>(t.size(), 1 + rng() % 4));
+        } else {
+            int words = 1 + static_cast<int>(rng() % 3);
+            for (int w = 0; w < words; ++w) req.text += (w ? " " : "") + term();
+        }
+    }
+    return requests;
+}
+
+static void printLatency(const char* name, const HdrHistogram& h) {
+    if (h.count() == 0) return;
+    auto ms = [](int64_t us) { return us / 1000.0; };
+    std::cout << "  " << std::left << std::setw(8) << name << std::right << " n=" << std::setw(8) << h.count()
+              << "  p50 " << std::setw(8) << ms(h.percentile(0.50)) << "  p90 " << std::setw(8) << ms(h.percentile(0.90))
+              << "  p99 " << std::setw(8) << ms(h.percentile(0.99)) << "  p99.9 " << std::setw(8) << ms(h.percentile(0.999))
+              << "  max " << std::setw(8) << ms(h.max()) << "  mean " << std::setw(8) << h.mean() / 1000.0 << " ms\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string baseUrl = "http://127.0.0.1:8080", logPath, indexPath = "Indexer/inverted_index.txt";
+    double rate = 100.0, duration = 30.0, warmup = 2.0, suggestRatio = 0.3, zipf = 1.0;
+    int connections = 64;
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() { return i + 1 < argc ? std::string(argv[++i]) : std::string(); };
+        if (arg == "--url") baseUrl = value();
+        else if (arg == "--rate") rate = std::atof(value().c_str());
+        else if (arg == "--duration") duration = std::atof(value().c_str());
+        else if (arg == "--warmup") warmup = std::atof(value().c_str());
+        else if (arg == "--connections") connections = std::atoi(value().c_str());
+        else if (arg == "--suggest-ratio") suggestRatio = std::atof(value().c_str());
+        else if (arg == "--zipf") zipf = std::atof(value().c_str());
+        else if (arg == "--log") logPath = value();
+        else if (arg == "--index") indexPath = value();
+        else if (arg == "--seed") seed = std::strtoull(value().c_str(), nullptr, 10);
+        else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return 1;
+        }
+    }
+    if (rate <= 0 || duration <= 0 || connections <= 0) {
+        std::cerr << "--rate, --duration and --connections must be positive\n";
+        return 1;
+    }
+
+    size_t total = static_cast<size_t>((warmup + duration) * rate);
+    std::vector<Request> requests;
+    if (!logPath.empty()) {
+        std::ifstream in(logPath);
+        std::vector<Request> logged;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+            Request r;
+            r.suggest = line.compare(0, 8, "suggest:") == 0;
+            r.text = r.suggest ? line.substr(8) : line;
+            logged.push_back(std::move(r));
+        }
+        if (logged.empty()) {
+            std::cerr << "No queries in " << logPath << "\n";
+            return 1;
+        }
+        for (size_t i = 0; i < total; ++i) requests.push_back(logged[i % logged.size()]);   // Replayed in order, looping
+    } else {
+        std::vector<std::string> terms = indexTerms(indexPath);
+        if (terms.empty()) {
+            std::cerr << "No terms in " << indexPath << " (pass --log or --index)\n";
+            return 1;
+        }
+        requests = synthesize(terms, total, zipf, suggestRatio, seed);
+    }
+
+    // Poisson arrivals: exponential gaps at the target rate
+    std::vector<Clock::duration> offsets(total);
+    {
+        std::mt19937_64 rng(seed ^ 0x9e3779b97f4a7c15ULL);
+        std::exponential_distribution<double> gap(rate);
+        double t = 0.0;
+        for (auto& o : offsets) {
+            o = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(t));
+            t += gap(rng);
+        }
+    }
+    size_t warmupCount = static_cast<size_t>(warmup * rate);
+
+    curl_global_init(CURL_GLOBAL_ALL);
+    std::cout << "[Load] " << baseUrl << "/api/search at " << rate << " req/s for " << duration << " s (+"
+              << warmup << " s warmup), " << connections << " connections, "
+              << (logPath.empty() ? "synthetic Zipf mix" : "log " + logPath) << "\n";
+
+    std::atomic<size_t> next{0};
+    std::vector<WorkerResult> results(connections);
+    std::vector<std::thread> workers;
+    Clock::time_point start = Clock::now() + std::chrono::milliseconds(100);
+
+    for (int w = 0; w < connections; ++w) {
+        workers.emplace_back([&, w]() {
+            WorkerResult& out = results[w];
+            CURL* curl = curl_easy_init();
+            uint64_t bytes = 0;
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discard);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &bytes);
+            curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
+            curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+            curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
+
+            size_t i;
+            while ((i = next.fetch_add(1)) < requests.size()) {
+                Clock::time_point scheduled = start + offsets[i];
+                std::this_thread::sleep_until(scheduled);
+
+                const Request& req = requests[i];
+                char* escaped = curl_easy_escape(curl, req.text.c_str(), static_cast<int>(req.text.size()));
+                std::string url = baseUrl + "/api/search?" + (req.suggest ? "suggest=" : "q=") + escaped;
+                curl_free(escaped);
+                curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+
+                CURLcode rc = curl_easy_perform(curl);
+                long status = 0;
+                curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+                int64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - scheduled).count();
+                if (i < warmupCount) continue;
+                if (rc != CURLE_OK || status != 200) {
+                    out.errors++;
+                    continue;
+                }
+                (req.suggest ? out.suggest : out.search).record(micros);
+            }
+            out.bytes = bytes;
+            curl_easy_cleanup(curl);
+        });
+    }
+    for (auto& t : workers) t.join();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count() - warmup;
+    curl_global_cleanup();
+
+    WorkerResult sum;
+    HdrHistogram all;
+    for (const auto& r : results) {
+        sum.search.merge(r.search);
+        sum.suggest.merge(r.suggest);
+        sum.errors += r.errors;
+        sum.bytes += r.bytes;
+    }
+    all.merge(sum.search);
+    all.merge(sum.suggest);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "[Load] " << all.count() << " ok, " << sum.errors << " errors in " << elapsed << " s: "
+              << all.count() / elapsed << " req/s achieved of " << rate << " offered, "
+              << sum.bytes / 1e6 << " MB received\n";
+    std::cout << "  latency from scheduled send time (ms):\n";
+    printLatency("search", sum.search);
+    printLatency("suggest", sum.suggest);
+    printLatency("all", all);
+    return sum.errors > 0 ? 2 : 0;
+}
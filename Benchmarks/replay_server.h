@@ -0,0 +1,310 @@
+#ifndef REPLAY_SERVER_H
+#define REPLAY_SERVER_H
+
+#include "../Storage/local_source.h"
+#include "../Storage/page_store.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Stand-in for the web: a small HTTP/1.1 keep-alive server on 127.0.0.1 that
+// serves a recorded corpus (page store, directory of saved HTML) or generated
+// pages, with injected latency, bandwidth limits and errors. Pages are keyed by
+// path, so recorded site-relative links ("/wiki/...") stay on the replay host.
+class ReplayServer {
+public:
+    using Generator = std::function<bool(const std::string& path, std::string& body)>;
+
+    struct Config {
+        int port = 0;                                // 0 = any free port
+        std::chrono::milliseconds latency{0};        // Added before every response
+        std::chrono::milliseconds jitter{0};         // Plus uniform [0, jitter)
+        uint64_t bandwidth = 0;                      // Bytes/sec per connection, 0 = unlimited
+        double errorRate = 0.0;                      // Fraction answered with 503
+        double resetRate = 0.0;                      // Fraction where the connection is dropped
+        std::string robotsTxt;                       // Served at /robots.txt; empty = 404
+    };
+
+    struct Counters {
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> notFound{0};
+        std::atomic<uint64_t> errors{0};             // Injected 503s
+        std::atomic<uint64_t> resets{0};             // Injected connection drops
+        std::atomic<uint64_t> bytesSent{0};
+    };
+
+private:
+    struct Page {
+        std::string contentType;
+        std::string body;
+    };
+
+    Config config;
+    std::unordered_map<std::string, Page> pages;     // Read-only once started
+    Generator generator;
+    Counters counters;
+
+    int listenFd = -1;
+    int boundPort = 0;
+    std::atomic<bool> running{false};
+    std::thread acceptor;
+    std::mutex connMtx;
+    std::unordered_map<std::thread::id, std::thread> connections;
+    std::vector<std::thread::id> finished;           // Exited, waiting to be joined by the acceptor
+    std::vector<int> openFds;
+
+    bool sendAll(int fd, const char* data, size_t len) {
+        // Throttled writes go out in ~50 ms slices
+        size_t slice = config.bandwidth ? std::max<uint64_t>(config.bandwidth / 20, 512) : len;
+        while (len > 0) {
+            size_t chunk = std::min(len, slice);
+            auto sliceStart = std::chrono::steady_clock::now();
+            size_t off = 0;
+            while (off < chunk) {
+                ssize_t n = ::send(fd, data + off, chunk - off, MSG_NOSIGNAL);
+                if (n <= 0) return false;
+                off += static_cast<size_t>(n);
+            }
+            counters.bytesSent += chunk;
+            data += chunk;
+            len -= chunk;
+            if (config.bandwidth && len > 0) {
+                auto budget = std::chrono::microseconds(chunk * 1000000 / config.bandwidth);
+                std::this_thread::sleep_until(sliceStart + budget);
+            }
+        }
+        return true;
+    }
+
+    void respond(int fd, std::mt19937_64& rng, const std::string& path, bool& keepAlive) {
+        counters.requests++;
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+        if (config.resetRate > 0 && coin(rng) < config.resetRate) {
+            counters.resets++;
+            keepAlive = false;
+            return;
+        }
+        auto delay = config.latency;
+        if (config.jitter.count() > 0) {
+            delay += std::chrono::milliseconds(std::uniform_int_distribution<long long>(0, config.jitter.count() - 1)(rng));
+        }
+        if (delay.count() > 0) std::this_thread::sleep_for(delay);
+
+        int status = 200;
+        const std::string* body = nullptr;
+        std::string contentType = "text/html; charset=utf-8";
+        static const std::string empty;
+        std::string generated;
+        if (config.errorRate > 0 && coin(rng) < config.errorRate) {
+            counters.errors++;
+            status = 503;
+        } else if (path == "/robots.txt" && !config.robotsTxt.empty()) {
+            body = &config.robotsTxt;
+            contentType = "text/plain";
+        } else {
+            auto it = pages.find(path);
+            if (it != pages.end()) {
+                body = &it->second.body;
+                contentType = it->second.contentType;
+            } else if (generator && generator(path, generated)) {
+                body = &generated;
+            } else {
+                counters.notFound++;
+                status = 404;
+            }
+        }
+        if (!body) body = &empty;
+
+        std::string head = "HTTP/1.1 " + std::to_string(status) +
+                           (status == 200 ? " OK" : status == 404 ? " Not Found" : " Service Unavailable") + "\r\n";
+        head += "Content-Type: " + contentType + "\r\n";
+        head += "Content-Length: " + std::to_string(body->size()) + "\r\n";
+        head += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+        if (!sendAll(fd, head.data(), head.size()) || !sendAll(fd, body->data(), body->size())) keepAlive = false;
+    }
+
+    void serve(int fd) {
+        std::mt19937_64 rng(std::hash<std::thread::id>()(std::this_thread::get_id()) ^ static_cast<uint64_t>(fd));
+        std::string buffer;
+        char chunk[8192];
+        bool keepAlive = true;
+        while (keepAlive && running) {
+            size_t end;
+            while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                pollfd pfd = {fd, POLLIN, 0};
+                if (::poll(&pfd, 1, 200) == 0) {
+                    if (!running) break;
+                    continue;
+                }
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    keepAlive = false;
+                    break;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            if (!keepAlive || end == std::string::npos) break;
+
+            std::string request = buffer.substr(0, end);
+            buffer.erase(0, end + 4);
+            size_t sp1 = request.find(' ');
+            size_t sp2 = request.find(' ', sp1 + 1);
+            if (sp1 == std::string::npos || sp2 == std::string::npos) break;
+            std::string path = request.substr(sp1 + 1, sp2 - sp1 - 1);
+
+            std::string lower = request;
+            std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+            if (lower.find("connection: close") != std::string::npos || lower.find(" http/1.0") != std::string::npos) {
+                keepAlive = false;
+            }
+            respond(fd, rng, path, keepAlive);
+        }
+        {
+            std::lock_guard<std::mutex> lock(connMtx);
+            openFds.erase(std::remove(openFds.begin(), openFds.end(), fd), openFds.end());
+            finished.push_back(std::this_thread::get_id());
+        }
+        ::close(fd);
+    }
+
+    // Join connection threads that have exited so a long run doesn't pile them up
+    void reapFinished() {
+        std::vector<std::thread> done;
+        {
+            std::lock_guard<std::mutex> lock(connMtx);
+            for (auto id : finished) {
+                auto it = connections.find(id);
+                if (it == connections.end()) continue;
+                done.push_back(std::move(it->second));
+                connections.erase(it);
+            }
+            finished.clear();
+        }
+        for (auto& t : done) t.join();
+    }
+
+    void acceptLoop() {
+        while (running) {
+            reapFinished();
+            pollfd pfd = {listenFd, POLLIN, 0};
+            if (::poll(&pfd, 1, 200) <= 0) continue;
+            int fd = ::accept(listenFd, nullptr, nullptr);
+            if (fd < 0) continue;
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            std::lock_guard<std::mutex> lock(connMtx);
+            openFds.push_back(fd);
+            std::thread t(&ReplayServer::serve, this, fd);
+            auto id = t.get_id();
+            connections.emplace(id, std::move(t));
+        }
+    }
+
+public:
+    explicit ReplayServer(const Config& cfg) : config(cfg) {}
+
+    ReplayServer(const ReplayServer&) = delete;
+    ReplayServer& operator=(const ReplayServer&) = delete;
+
+    ~ReplayServer() { stop(); }
+
+    // Corpus setup (before start())
+    void addPage(const std::string& path, std::string body, const std::string& contentType = "text/html; charset=utf-8") {
+        pages[path] = Page{contentType, std::move(body)};
+    }
+
+    // Every response / resource record of a WARC (e.g. the crawler's page store)
+    size_t loadStore(const std::string& path) {
+        PageStoreReader reader(path);
+        StoredPage page;
+        size_t before = pages.size();
+        while (reader.next(page)) addPage(pathOf(page.url), std::move(page.body));
+        return pages.size() - before;
+    }
+
+    // Saved HTML, with URLs as for --ingest
+    size_t loadDirectory(const std::string& dir, const LocalUrlMapper& mapper) {
+        DirectorySource source(dir, mapper);
+        StoredPage page;
+        size_t before = pages.size();
+        while (source.next(page)) addPage(pathOf(page.url), std::move(page.body));
+        return pages.size() - before;
+    }
+
+    // Renders paths that are not in the page map (synthetic corpora too big to hold)
+    void setGenerator(Generator g) { generator = std::move(g); }
+
+    size_t pageCount() const { return pages.size(); }
+
+    // "https://host/wiki/X?y#z" -> "/wiki/X?y"
+    static std::string pathOf(const std::string& url) {
+        size_t scheme = url.find("://");
+        size_t start = scheme == std::string::npos ? 0 : url.find('/', scheme + 3);
+        if (start == std::string::npos) return "/";
+        std::string path = url.substr(start);
+        size_t hash = path.find('#');
+        if (hash != std::string::npos) path.erase(hash);
+        return path.empty() ? "/" : path;
+    }
+
+
+    bool start() {
+        listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listenFd < 0) return false;
+        int one = 1;
+        ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(static_cast<uint16_t>(config.port));
+        socklen_t len = sizeof(addr);
+        if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(listenFd, 256) != 0 ||
+            ::getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            std::perror("[Replay] bind");
+            ::close(listenFd);
+            listenFd = -1;
+            return false;
+        }
+        boundPort = ntohs(addr.sin_port);
+        running = true;
+        acceptor = std::thread(&ReplayServer::acceptLoop, this);
+        return true;
+    }
+
+    void stop() {
+        if (!running.exchange(false)) return;
+        if (acceptor.joinable()) acceptor.join();
+        {
+            std::lock_guard<std::mutex> lock(connMtx);
+            for (int fd : openFds) ::shutdown(fd, SHUT_RDWR);
+        }
+        for (auto& c : connections) if (c.second.joinable()) c.second.join();
+        connections.clear();
+        finished.clear();
+        ::close(listenFd);
+        listenFd = -1;
+    }
+
+    int port() const { return boundPort; }
+    std::string baseUrl() const { return "http://127.0.0.1:" + std::to_string(boundPort); }
+    const Counters& stats() const { return counters; }
+};
+
+#endif
@@ -0,0 +1,189 @@
+// Scale test for the index, trie, graph, PageRank and query path on a synthetic
+// web (Zipf vocabulary, preferential-attachment links), or a generator that
+// writes / serves that corpus for the other tools.
+//
+//   g++ -std=c++17 -O2 -I.. -o scale_test scale_test.cpp -lcurl -lpthread -lz
+//       (add -DATMX_COUNT_ALLOCATIONS to check the memory report against live heap bytes)
+//   ./scale_test [--pages N] [--vocabulary N] [--zipf s] [--words N] [--links N]
+//                [--seed N] [--threads N] [--queries N]
+//   ./scale_test --pages N --write corpus.warc.gz|<dir>     then: server --ingest <path>
+//   ./scale_test --pages N --serve [port]                   http://127.0.0.1:<port>/wiki/Page_<i>
+#include "replay_server.h"
+#include "synthetic_corpus.h"
+#include "../Data_Structures/graph.h"
+#include "../Data_Structures/hashset.h"
+#include "../Data_Structures/trie.h"
+#include "../Indexer/bulk_indexer.h"
+#include "../Indexer/inverted_index.h"
+#include "../Metrics/memory_report.h"
+#include "../Ranker/ranker.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+static double residentMB() {
+    return MemoryReport::residentBytes() / static_cast<double>(1 << 20);
+}
+
+// Times one phase and prints it with the resident set size afterwards
+class Phase {
+private:
+    const char* name;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+public:
+    explicit Phase(const char* phaseName) : name(phaseName) {
+        std::cout << "[Scale] " << name << "..." << std::flush;
+    }
+
+    double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void done(const std::string& detail = "") {
+        std::cout << " " << std::fixed << std::setprecision(3) << seconds() << " s, RSS "
+                  << std::setprecision(0) << residentMB() << " MB" << (detail.empty() ? "" : " | " + detail) << "\n";
+    }
+};
+
+int main(int argc, char* argv[]) {
+    SyntheticCorpus::Config corpusConfig;
+    corpusConfig.vocabulary = 2000;                  // The index keeps a 10007-bucket HashMap per term
+    int threads = 0, queries = 20, port = 0;
+    std::string writePath;
+    bool serve = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() { return i + 1 < argc ? std::string(argv[++i]) : std::string(); };
+        if (arg == "--pages") corpusConfig.pages = std::strtoull(value().c_str(), nullptr, 10);
+        else if (arg == "--vocabulary") corpusConfig.vocabulary = std::strtoull(value().c_str(), nullptr, 10);
+        else if (arg == "--zipf") corpusConfig.zipfExponent = std::atof(value().c_str());
+        else if (arg == "--words") corpusConfig.wordsPerPage = std::strtoull(value().c_str(), nullptr, 10);
+        else if (arg == "--links") corpusConfig.linksPerPage = std::strtoull(value().c_str(), nullptr, 10);
+        else if (arg == "--seed") corpusConfig.seed = std::strtoull(value().c_str(), nullptr, 10);
+        else if (arg == "--threads") threads = std::atoi(value().c_str());
+        else if (arg == "--queries") queries = std::atoi(value().c_str());
+        else if (arg == "--write") writePath = value();
+        else if (arg == "--serve") {
+            serve = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') port = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::cout << "[Scale] " << corpusConfig.pages << " pages, vocabulary " << corpusConfig.vocabulary
+              << " (zipf " << corpusConfig.zipfExponent << "), ~" << corpusConfig.wordsPerPage << " words and "
+              << corpusConfig.linksPerPage << "+" << corpusConfig.randomLinks << " links per page\n";
+
+    Phase generate("link graph");
+    SyntheticCorpus corpus(corpusConfig);
+    generate.done();
+
+    if (!writePath.empty()) {
+        Phase write("write corpus");
+        bool isWarc = writePath.size() > 5 && writePath.find(".warc") != std::string::npos;
+        bool ok = isWarc ? corpus.writeWarc(writePath) : corpus.writeDirectory(writePath);
+        write.done(writePath);
+        if (!ok) std::cerr << "[Scale] Failed to write " << writePath << "\n";
+        return ok ? 0 : 1;
+    }
+
+    if (serve) {
+        ReplayServer::Config serverConfig;
+        serverConfig.port = port;
+        serverConfig.robotsTxt = "User-agent: *\nDisallow:\n";
+        ReplayServer server(serverConfig);
+        server.setGenerator([&corpus](const std::string& path, std::string& body) { return corpus.render(path, body); });
+        if (!server.start()) return 1;
+        std::cout << "[Scale] Serving " << server.baseUrl() << corpus.path(0) << " .. " << corpus.path(corpus.size() - 1)
+                  << " (EOF on stdin stops)\n";
+        while (std::getchar() != EOF) {}
+        server.stop();
+        std::cout << "[Scale] " << server.stats().requests << " requests served\n";
+        return 0;
+    }
+
+    // ── Index: HashMap / InvertedIndex, Trie, Graph ──
+    InvertedIndex index;
+    Trie trie;
+    Graph graph;
+    BulkIndexer::Config bulkConfig;
+    bulkConfig.threads = threads;
+    size_t next = 0;
+    Phase indexing("index");
+    BulkIndexer::Stats stats = BulkIndexer::run(
+        [&](StoredPage& page) {
+            if (next >= corpus.size()) return false;
+            page.url = corpus.url(next);
+            page.body = corpus.html(next);
+            next++;
+            return true;
+        },
+        index, trie, graph, bulkConfig);
+    std::ostringstream detail;
+    detail << std::fixed << std::setprecision(1) << stats.pagesPerSec() << " pages/s, " << stats.mbPerSec()
+           << " MB/s, " << index.getAllWords().size() << " terms, " << graph.size() << " graph nodes";
+    indexing.done(detail.str());
+
+    // ── PageRank ──
+    Phase pagerank("PageRank (20 iterations)");
+    HashMap<double> ranks = Ranker::computePageRank(graph, 20, 0.85);
+    pagerank.done(std::to_string(ranks.size()) + " ranked");
+
+    MemoryReport memory;
+    memory.add("index.postings", index.postingsMemory());
+    memory.add("index.doc_lengths", index.docLengthMemory());
+    memory.add("trie", trie.memoryUsage());
+    memory.add("graph", graph.memoryUsage());
+    memory.add("pagerank", ranks.memoryUsage());
+    memory.setDocuments(index.getDocCount());
+    memory.print(std::cout, "[Memory]");
+
+    std::mt19937_64 rng(corpusConfig.seed + 1);
+
+    // ── Trie suggestions: prefixes of Zipf-sampled words, as users type them ──
+    Phase suggest("trie suggestions");
+    size_t suggestions = 0;
+    const int prefixes = 1000;
+    for (int q = 0; q < prefixes; ++q) {
+        std::string w = SyntheticCorpus::word(corpus.sampleRank(rng));
+        suggestions += trie.getSuggestions(w.substr(0, 1 + rng() % 3), 10).size();
+    }
+    std::ostringstream suggestDetail;
+    suggestDetail << std::fixed << std::setprecision(1) << suggest.seconds() * 1e6 / prefixes << " us/prefix, "
+                  << suggestions << " suggestions";
+    suggest.done(suggestDetail.str());
+
+    // ── Query path of /api/search: postings union, BM25 per (term, doc), PageRank, top 20 ──
+    Phase query("queries");
+    size_t results = 0;
+    for (int q = 0; q < queries; ++q) {
+        std::vector<std::string> terms = {SyntheticCorpus::word(corpus.sampleRank(rng)),
+                                          SyntheticCorpus::word(corpus.sampleRank(rng))};
+        HashSet candidates;
+        for (const auto& t : terms) {
+            for (const auto& u : index.getPostings(t).getKeys()) candidates.insert(u);
+        }
+        std::vector<Ranker::ScoredDoc> scored;
+        for (const auto& url : candidates.getAll()) {
+            double tfidf = 0.0;
+            for (const auto& t : terms) tfidf += Ranker::computeTFIDF(index, t, url);
+            double score = Ranker::computeFinalScore(tfidf, ranks.get(url), 0.0);
+            if (score > 0.001) scored.emplace_back(score, url);
+        }
+        results += Ranker::getTopK(scored, 20).size();
+    }
+    std::ostringstream queryDetail;
+    queryDetail << std::fixed << std::setprecision(2) << (queries ? query.seconds() * 1000.0 / queries : 0.0)
+                << " ms/query, " << results << " results";
+    query.done(queryDetail.str());
+    return 0;
+}
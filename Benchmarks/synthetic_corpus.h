@@ -0,0 +1,190 @@
+#ifndef SYNTHETIC_CORPUS_H
+#define SYNTHETIC_CORPUS_H
+
+#include "../Storage/page_store.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+// Deterministic synthetic web for scale testing. Words are drawn from a Zipf
+// distribution over a generated vocabulary (rank r has probability ~ 1/r^s),
+// and links follow preferential attachment: each new page links to pages in
+// proportion to the links they already have, which gives the power-law
+// in-degrees of the real web. A few uniform random links per page keep the
+// graph crawlable from any start page.
+//
+// Only the link graph is kept in memory (linksPerPage uint32 per page); HTML is
+// rendered on demand from a per-page seed, so html(i) is the same on every call.
+class SyntheticCorpus {
+public:
+    struct Config {
+        size_t pages = 10000;
+        size_t vocabulary = 50000;
+        double zipfExponent = 1.0;
+        size_t wordsPerPage = 300;             // Mean; actual is uniform in [w/2, 3w/2)
+        size_t linksPerPage = 8;               // Preferential-attachment links
+        size_t randomLinks = 2;                // Uniform links on top
+        uint64_t seed = 42;
+        std::string baseUrl = "https://en.wikipedia.org";
+    };
+
+private:
+    Config config;
+    std::vector<double> cdf;                   // Zipf CDF over vocabulary ranks
+    std::vector<uint32_t> targets;             // Page i >= 1 links to targets[(i-1)*m .. i*m)
+
+    static uint64_t mix(uint64_t h) {
+        h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+    void buildVocabulary() {
+        cdf.resize(config.vocabulary);
+        double sum = 0.0;
+        for (size_t r = 0; r < config.vocabulary; ++r) {
+            sum += 1.0 / std::pow(static_cast<double>(r + 1), config.zipfExponent);
+            cdf[r] = sum;
+        }
+        for (auto& c : cdf) c /= sum;
+    }
+
+    // Barabási–Albert: a random endpoint of an existing edge is a node picked
+    // with probability proportional to its degree. Edge e's source is e/m + 1,
+    // so only the targets need storing.
+    void buildLinks() {
+        size_t m = config.linksPerPage;
+        if (config.pages < 2 || m == 0) return;
+        targets.resize((config.pages - 1) * m);
+        std::mt19937_64 rng(config.seed);
+        for (size_t i = 1; i < config.pages; ++i) {
+            size_t edges = (i - 1) * m;
+            for (size_t k = 0; k < m; ++k) {
+                uint32_t target;
+                if (edges == 0 || rng() % 10 == 0) {
+                    target = static_cast<uint32_t>(rng() % i);        // Some uniform mass so new pages get found
+                } else {
+                    size_t e = rng() % edges;
+                    target = (rng() & 1) ? targets[e] : static_cast<uint32_t>(e / m + 1);
+                }
+                targets[edges + k] = target;
+            }
+        }
+    }
+
+public:
+    explicit SyntheticCorpus(const Config& cfg) : config(cfg) {
+        if (config.vocabulary == 0) config.vocabulary = 1;
+        buildVocabulary();
+        buildLinks();
+    }
+
+    size_t size() const { return config.pages; }
+    const Config& settings() const { return config; }
+
+    // Vocabulary word of rank r: consonant-vowel syllables, never a stop word
+    static std::string word(size_t rank) {
+        static const char* syllables[] = {"ka", "lo", "mi", "nu", "re", "sa", "ti", "vo",
+                                          "de", "gu", "pa", "zo", "fe", "hi", "jo", "bu"};
+        std::string w;
+        for (size_t n = rank + 16; n > 0; n /= 16) w += syllables[n % 16];
+        return w;
+    }
+
+    size_t sampleRank(std::mt19937_64& rng) const {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return std::min<size_t>(std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin(), cdf.size() - 1);
+    }
+
+    std::string path(size_t i) const { return "/wiki/Page_" + std::to_string(i); }
+    std::string url(size_t i) const { return config.baseUrl + path(i); }
+
+    // Page ids page i links to (preferential + random), in document order
+    std::vector<uint32_t> links(size_t i) const {
+        std::vector<uint32_t> out;
+        size_t m = config.linksPerPage;
+        if (i >= 1 && i < config.pages && m > 0) out.assign(targets.begin() + (i - 1) * m, targets.begin() + i * m);
+        std::mt19937_64 rng(mix(config.seed ^ (i * 0x9e3779b97f4a7c15ULL) ^ 0x5bd1e995));
+        for (size_t k = 0; k < config.randomLinks && config.pages > 1; ++k) {
+            out.push_back(static_cast<uint32_t>(rng() % config.pages));
+        }
+        return out;
+    }
+
+    std::string html(size_t i) const {
+        std::mt19937_64 rng(mix(config.seed ^ (i * 0x9e3779b97f4a7c15ULL)));
+        size_t words = config.wordsPerPage / 2 + (config.wordsPerPage ? rng() % config.wordsPerPage : 0);
+        std::vector<uint32_t> out = links(i);
+
+        std::string title = word(sampleRank(rng)) + " " + word(sampleRank(rng)) + " " + word(sampleRank(rng));
+        std::string page;
+        page.reserve(words * 8 + out.size() * 40 + 256);
+        page += "<!DOCTYPE html>\n<html><head><title>" + title + "</title></head>\n<body>\n<h1>" + title + "</h1>\n<p>";
+
+        // Links are spread through the text, as in an article
+        size_t nextLink = 0;
+        size_t linkEvery = out.empty() ? words + 1 : words / out.size() + 1;
+        for (size_t w = 0; w < words; ++w) {
+            if (w % linkEvery == linkEvery - 1 && nextLink < out.size()) {
+                page += "<a href=\"" + path(out[nextLink++]) + "\">" + word(sampleRank(rng)) + "</a> ";
+            } else {
+                page += word(sampleRank(rng));
+                page += (w % 40 == 39) ? "</p>\n<p>" : " ";
+            }
+        }
+        while (nextLink < out.size()) page += "<a href=\"" + path(out[nextLink++]) + "\">see also</a> ";
+        page += "</p>\n</body></html>\n";
+        return page;
+    }
+
+    // "/wiki/Page_<i>" -> page i (false for anything else)
+    bool render(const std::string& requestPath, std::string& body) const {
+        static const std::string prefix = "/wiki/Page_";
+        if (requestPath.compare(0, prefix.size(), prefix) != 0) return false;
+        char* end = nullptr;
+        unsigned long long i = std::strtoull(requestPath.c_str() + prefix.size(), &end, 10);
+        if (end == requestPath.c_str() + prefix.size() || *end != '\0' || i >= config.pages) return false;
+        body = html(static_cast<size_t>(i));
+        return true;
+    }
+
+    // Whole corpus as a .warc.gz page store (what --ingest / --reindex read)
+    bool writeWarc(const std::string& path) const {
+        std::remove(path.c_str());
+        PageStore store(path);
+        if (!store.isOpen()) return false;
+        std::time_t now = std::time(nullptr);
+        for (size_t i = 0; i < config.pages; ++i) {
+            if (!store.append(url(i), now, "", html(i))) return false;
+        }
+        return true;
+    }
+
+    // <dir>/<host>/wiki/Page_<i>.html, the layout --ingest maps back to URLs
+    bool writeDirectory(const std::string& dir) const {
+        std::string host = config.baseUrl.substr(config.baseUrl.find("://") + 3);
+        std::string wikiDir = dir + "/" + host + "/wiki";
+        ::mkdir(dir.c_str(), 0755);
+        ::mkdir((dir + "/" + host).c_str(), 0755);
+        ::mkdir(wikiDir.c_str(), 0755);
+        for (size_t i = 0; i < config.pages; ++i) {
+            std::string file = wikiDir + "/Page_" + std::to_string(i) + ".html";
+            FILE* f = std::fopen(file.c_str(), "wb");
+            if (!f) return false;
+            std::string page = html(i);
+            bool ok = std::fwrite(page.data(), 1, page.size(), f) == page.size();
+            if (std::fclose(f) != 0 || !ok) return false;
+        }
+        return true;
+    }
+};
+
+#endif
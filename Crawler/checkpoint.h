@@ -0,0 +1,126 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// On-disk crawl checkpoint:
+//
+//   <dir>/segment-000001.log ...   what was indexed between two checkpoints
+//   <dir>/state                    frontier + number of segments (rewritten each time)
+//
+// Segments are append-only deltas, so a checkpoint costs the pages indexed since
+// the last one plus the frontier, not the whole index. Every file is written to a
+// temp name, fsynced and renamed, so a crash mid-checkpoint leaves the previous
+// one intact. Segment lines:
+//
+//   doc   <fingerprint> <simhash> <url>
+//   alias <fingerprint> <canonical fingerprint> <canonical url>
+//   edge  <from> <to>
+//   post  <word> <url> <term frequency>
+class CrawlCheckpoint {
+public:
+    struct State {
+        uint64_t segments = 0;                 // segment-000001 .. segment-<segments>
+        std::vector<std::string> frontier;
+    };
+
+private:
+    std::string dir;
+
+    std::string segmentPath(uint64_t id) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "/segment-%06llu.log", static_cast<unsigned long long>(id));
+        return dir + name;
+    }
+
+public:
+    explicit CrawlCheckpoint(const std::string& directory) : dir(directory) {}
+
+    const std::string& directory() const { return dir; }
+
+    // temp file -> fsync -> rename over `path`
+    static bool writeFileAtomic(const std::string& path, const std::string& data) {
+        std::string tmp = path + ".tmp";
+        FILE* f = std::fopen(tmp.c_str(), "wb");
+        if (!f) return false;
+        bool ok = std::fwrite(data.data(), 1, data.size(), f) == data.size();
+        ok = ok && std::fflush(f) == 0 && fsync(fileno(f)) == 0;
+        ok = (std::fclose(f) == 0) && ok;
+        if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+            std::remove(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // Removes the state file and every segment (the crawl they describe is saved)
+    void clear() const {
+        std::remove((dir + "/state").c_str());
+        DIR* d = ::opendir(dir.c_str());
+        if (!d) return;
+        while (dirent* e = ::readdir(d)) {
+            std::string name = e->d_name;
+            if (name.compare(0, 8, "segment-") == 0) std::remove((dir + "/" + name).c_str());
+        }
+        ::closedir(d);
+    }
+
+    bool exists() const {
+        struct stat st;
+        return ::stat((dir + "/state").c_str(), &st) == 0;
+    }
+
+    // Writes segment `id`, then the state that makes it visible
+    bool save(uint64_t id, const std::string& segment, const State& state) {
+        ::mkdir(dir.c_str(), 0755);
+        if (!segment.empty() && !writeFileAtomic(segmentPath(id), segment)) return false;
+
+        std::ostringstream out;
+        out << "atmx-checkpoint 1\n";
+        out << "segments " << state.segments << "\n";
+        out << "frontier " << state.frontier.size() << "\n";
+        for (const auto& url : state.frontier) out << url << "\n";
+        return writeFileAtomic(dir + "/state", out.str());
+    }
+
+    bool loadState(State& state) const {
+        std::ifstream in(dir + "/state");
+        std::string magic, key;
+        int version = 0;
+        size_t count = 0;
+        if (!(in >> magic >> version) || magic != "atmx-checkpoint" || version != 1) return false;
+        if (!(in >> key >> state.segments) || key != "segments") return false;
+        if (!(in >> key >> count) || key != "frontier") return false;
+        state.frontier.clear();
+        state.frontier.reserve(count);
+        std::string url;
+        std::getline(in, url);
+        while (state.frontier.size() < count && std::getline(in, url)) {
+            if (!url.empty()) state.frontier.push_back(url);
+        }
+        return true;
+    }
+
+    // Feeds every line of segments 1..count to `apply`, in order. Missing
+    // segments are skipped (a checkpoint that indexed nothing writes none).
+    void replay(uint64_t count, const std::function<void(const std::string&)>& apply) const {
+        for (uint64_t id = 1; id <= count; ++id) {
+            std::ifstream in(segmentPath(id));
+            std::string line;
+            while (std::getline(in, line)) {
+                if (!line.empty()) apply(line);
+            }
+        }
+    }
+};
+
+#endif
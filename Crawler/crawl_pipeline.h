@@ -0,0 +1,689 @@
+#ifndef CRAWL_PIPELINE_H
+#define CRAWL_PIPELINE_H
+
+#include "link_parser.h"
+#include "multiplex_downloader.h"
+#include "politeness_scheduler.h"
+#include "robots.h"
+#include "url_canonicalizer.h"
+#include "url_filter.h"
+#include "checkpoint.h"
+#include "../Data_Structures/thread_safe_queue.h"
+#include "../Data_Structures/concurrent_url_set.h"
+#include "../Data_Structures/graph.h"
+#include "../Data_Structures/trie.h"
+#include "../Indexer/inverted_index.h"
+#include "../Indexer/document_table.h"
+#include "../Indexer/near_duplicate.h"
+#include "../Indexer/write_ahead_log.h"
+#include "../Logger/logger.h"
+#include "../Metrics/metrics.h"
+#include "../Scraper/scraper.h"
+#include "../Storage/page_store.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Crawl split into three stages connected by bounded queues:
+//
+//   fetch  ──fetchedQueue──▶  parse/extract  ──parsedQueue──▶  index/graph
+//
+// Each stage has its own thread pool. Fetchers block on a full fetchedQueue when
+// parsing falls behind (and parsers likewise on parsedQueue), so memory stays
+// bounded. Only the index stage touches the shared index, trie and graph.
+class CrawlPipeline {
+public:
+    struct Config {
+        int fetchThreads = 4;
+        int parseThreads = 2;
+        int indexThreads = 1;
+        size_t fetchedQueueCapacity = 64;    // Raw HTML pages waiting to be parsed
+        size_t parsedQueueCapacity = 64;     // Token lists waiting to be indexed
+        int maxPages = 25;
+        size_t linksPerPage = 200;           // Expected fan-out, sizes the enqueue filter
+        size_t expectedUrls = 0;             // URLs ever enqueued; 0 = maxPages * linksPerPage
+        PolitenessScheduler::Config politeness;
+        MultiplexDownloader::Config fetch;
+        UrlFilter linkFilter = UrlFilter::wikipediaDefaults();
+        bool respectRobots = true;
+        RobotsCache::Config robots;
+        bool detectNearDuplicates = true;
+        NearDuplicateIndex::Config nearDuplicates;
+        std::string checkpointDir;                   // Empty disables checkpoints
+        std::chrono::seconds checkpointInterval{60};
+        bool writeAheadLog = true;                   // Log every indexed page to <checkpointDir>/wal-*.log
+        WriteAheadLog::Config wal;
+        std::string pageStorePath;                   // Archive indexed pages here (.warc.gz); empty = off
+    };
+
+    struct StageStats {
+        static const int BUCKETS = 40;               // Power-of-two microsecond buckets, up to ~6 days
+
+        std::atomic<uint64_t> processed{0};
+        std::atomic<uint64_t> busyNanos{0};
+        std::atomic<uint64_t> histogram[BUCKETS] = {};
+
+        void record(std::chrono::steady_clock::time_point start) {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            uint64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            busyNanos += nanos;
+            uint64_t micros = nanos / 1000;
+            int bucket = micros ? 64 - __builtin_clzll(micros) : 0;
+            histogram[bucket < BUCKETS ? bucket : BUCKETS - 1]++;
+            processed++;
+        }
+
+        double avgMillis() const {
+            uint64_t n = processed.load();
+            return n ? busyNanos.load() / 1e6 / n : 0.0;
+        }
+
+        // Upper bound of the bucket holding quantile q (0..1), so within 2x
+        double percentileMillis(double q) const {
+            uint64_t n = processed.load();
+            if (n == 0) return 0.0;
+            uint64_t rank = static_cast<uint64_t>(q * n), seen = 0;
+            for (int b = 0; b < BUCKETS; ++b) {
+                seen += histogram[b].load();
+                if (seen > rank) return (b == 0 ? 1 : (uint64_t(1) << b)) / 1000.0;
+            }
+            return (uint64_t(1) << (BUCKETS - 1)) / 1000.0;
+        }
+    };
+
+private:
+    struct FetchedPage {
+        std::string url;                     // Canonical, as requested
+        uint64_t fingerprint = 0;
+        std::string effectiveUrl;            // After redirects
+        std::string headers;
+        std::time_t fetchedAt = 0;
+        std::string html;
+    };
+
+    struct ParsedPage {
+        std::string url;                     // Canonical document URL
+        uint64_t fingerprint = 0;
+        uint64_t simhash = 0;
+        std::vector<CanonicalUrl> links;
+        std::vector<std::string> words;
+    };
+
+    Config config;
+    InvertedIndex& invIndex;
+    Trie& wordTrie;
+    Graph& linkGraph;
+    std::ostream& visitedLog;
+
+    PolitenessScheduler scheduler;
+    MultiplexDownloader downloader;
+    RobotsCache robots;                      // Feeds Crawl-delay into the scheduler
+    ConcurrentUrlSet visitedURLs;            // Requested URLs and the canonical URLs they resolved to
+    DocumentTable documents;
+    NearDuplicateIndex nearDuplicates;       // SimHash of every page indexed so far
+    ConcurrentUrlSet seenURLs;               // Every URL ever enqueued (exact, Bloom-fronted)
+    ThreadSafeQueue<FetchedPage> fetchedQueue;
+    ThreadSafeQueue<ParsedPage> parsedQueue;
+
+    std::mutex indexMutex;                   // invIndex + wordTrie
+    std::mutex graphMutex;                   // linkGraph
+    std::mutex logMutex;                     // visitedLog (console output goes through Logger)
+
+    std::atomic<bool> crawling{false};
+    std::atomic<int> processedCount{0};
+    std::atomic<uint64_t> duplicatesSkipped{0};
+    std::atomic<uint64_t> nearDuplicatesSkipped{0};
+    std::atomic<uint64_t> abortedDownloads{0};       // Cut off by content-type / size limits
+    std::atomic<uint64_t> fetchedBytes{0};
+    std::atomic<int> busyWorkers{0};                 // Threads holding a URL or page between queues
+
+    // Counts a worker as busy for its scope (idle() needs every stage quiet)
+    struct BusyScope {
+        std::atomic<int>& count;
+        explicit BusyScope(std::atomic<int>& c) : count(c) { count++; }
+        ~BusyScope() { count--; }
+    };
+
+    // Everything indexed since the last checkpoint, in segment format (see checkpoint.h)
+    CrawlCheckpoint checkpoints;
+    std::mutex journalMutex;
+    std::string journal;
+    std::mutex checkpointMutex;              // One checkpoint at a time
+    uint64_t segmentCount = 0;
+    std::chrono::steady_clock::time_point lastCheckpoint;
+
+    // Same records, durable between checkpoints (null when checkpoints are off)
+    std::unique_ptr<WriteAheadLog> wal;
+    uint64_t walGeneration = 1;
+    bool resumed = false;
+    std::vector<std::string> replayedTargets;    // Link targets seen while resuming
+
+    std::unique_ptr<PageStore> pageStore;        // Raw HTML of every indexed page, for reindexing
+    std::chrono::steady_clock::time_point startedAt;
+
+    std::vector<std::thread> fetchers, parsers, indexers;
+    StageStats fetchStats, parseStats, indexStats;
+
+    // /metrics series; process-wide, so the server still reports the crawl after it ends
+    struct CrawlMetrics {
+        MetricCounter& fetched = MetricsRegistry::global().counter(
+            "atmx_crawl_pages_fetched_total", "Pages downloaded successfully");
+        MetricCounter& failed = MetricsRegistry::global().counter(
+            "atmx_crawl_fetch_failures_total", "Downloads that failed or were aborted");
+        MetricCounter& bytes = MetricsRegistry::global().counter(
+            "atmx_crawl_bytes_total", "Body bytes downloaded");
+        MetricCounter& indexed = MetricsRegistry::global().counter(
+            "atmx_crawl_pages_indexed_total", "Pages added to the index by the crawler");
+        MetricGauge& frontier = MetricsRegistry::global().gauge(
+            "atmx_crawl_frontier_urls", "URLs waiting in the politeness scheduler");
+
+        // Hosts past the first MAX_HOST_SERIES share host="other", so a wide crawl
+        // cannot grow /metrics without bound
+        static constexpr size_t MAX_HOST_SERIES = 64;
+        std::mutex hostMutex;
+        std::unordered_map<std::string, MetricHistogram*> hostSeries;
+        MetricHistogram& otherHosts = hostHistogram("other");
+
+        static MetricHistogram& hostHistogram(const std::string& host) {
+            return MetricsRegistry::global().histogram("atmx_crawl_fetch_duration_seconds",
+                                                       "Page download time per host",
+                                                       "host=\"" + MetricsRegistry::escapeLabel(host) + "\"");
+        }
+
+        static CrawlMetrics& get() {
+            static CrawlMetrics instance;
+            return instance;
+        }
+
+        MetricHistogram& hostLatency(const std::string& host) {
+            std::lock_guard<std::mutex> lock(hostMutex);
+            auto it = hostSeries.find(host);
+            if (it != hostSeries.end()) return *it->second;
+            if (hostSeries.size() >= MAX_HOST_SERIES) return otherHosts;
+            MetricHistogram* h = &hostHistogram(host);
+            hostSeries.emplace(host, h);
+            return *h;
+        }
+
+        // Latency series of the URL's host ("https://" dropped from the label).
+        // Each fetcher keeps its own host -> series map, so only a host's first
+        // fetch on a thread touches a lock.
+        static MetricHistogram& fetchLatency(const std::string& url) {
+            thread_local std::unordered_map<std::string, MetricHistogram*> cache;
+            std::string host = getDomain(url);
+            auto it = cache.find(host);
+            if (it != cache.end()) return *it->second;
+            if (cache.size() >= 4096) cache.clear();
+            size_t scheme = host.find("://");
+            MetricHistogram& h = get().hostLatency(scheme == std::string::npos ? host : host.substr(scheme + 3));
+            cache.emplace(std::move(host), &h);
+            return h;
+        }
+    };
+    CrawlMetrics& metrics = CrawlMetrics::get();
+
+    static ConcurrentUrlSet::Config visitedSetConfig() {
+        ConcurrentUrlSet::Config c;
+        c.bloomExpectedItems = 1000000;      // Lock-free "not visited" answers for links
+        return c;
+    }
+
+    // The enqueue gate must never drop a new URL on a Bloom false positive, so
+    // the Bloom filter only fronts the exact set; it is sized from the crawl
+    static ConcurrentUrlSet::Config seenSetConfig(const Config& cfg) {
+        ConcurrentUrlSet::Config c;
+        c.bloomExpectedItems = cfg.expectedUrls
+                                   ? cfg.expectedUrls
+                                   : static_cast<size_t>(std::max(cfg.maxPages, 1)) * cfg.linksPerPage;
+        c.bloomFalsePositiveRate = 0.001;
+        return c;
+    }
+
+    // robots.txt is text/plain; files past 500 KiB (the RFC 9309 minimum) count as missing
+    static DownloadLimits robotsLimits() {
+        DownloadLimits l;
+        l.htmlOnly = false;
+        l.maxBytes = 500 * 1024;
+        return l;
+    }
+
+    // Journal and WAL take records in the same order, so a checkpoint can cut both at one point
+    void appendJournal(const std::string& record) {
+        std::lock_guard<std::mutex> lock(journalMutex);
+        journal += record;
+        if (wal) wal->append(record);
+    }
+
+    void recordAlias(uint64_t aliasFp, uint64_t canonicalFp, const std::string& canonicalUrl) {
+        documents.addAlias(aliasFp, canonicalFp, canonicalUrl);
+        if (config.checkpointDir.empty()) return;
+        appendJournal("alias " + std::to_string(aliasFp) + " " + std::to_string(canonicalFp) + " " + canonicalUrl + "\n");
+    }
+
+    // Reserves one of the maxPages slots; stops the crawl once they are gone
+    bool claimPageSlot() {
+        int n = processedCount.load();
+        while (n < config.maxPages) {
+            if (processedCount.compare_exchange_weak(n, n + 1)) return true;
+        }
+        crawling = false;
+        return false;
+    }
+
+    // ── Stage 1: politeness-scheduled fetch ──
+    void fetchLoop() {
+        while (crawling) {
+            std::string url;
+            if (!scheduler.next(url, std::chrono::milliseconds(100))) continue;
+            BusyScope busy(busyWorkers);
+
+            // Frontier URLs are already canonical, so hashing the string is enough
+            uint64_t fp = fingerprint64(url);
+            if (visitedURLs.contains(fp) || processedCount >= config.maxPages) {
+                scheduler.release(url);
+                continue;
+            }
+            // First URL of a host downloads and compiles its robots.txt
+            if (config.respectRobots && !robots.allowed(url)) {
+                scheduler.release(url);
+                continue;
+            }
+            LOG_DEBUG("[Worker] Processing: " << url);
+
+            auto start = std::chrono::steady_clock::now();
+            FetchResult result = downloader.fetchPage(url);
+            scheduler.release(url);
+            fetchStats.record(start);
+            CrawlMetrics::fetchLatency(url).observe(
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            metrics.frontier.set(static_cast<int64_t>(scheduler.size()));
+            if (!result.ok()) {
+                if (!result.abortReason.empty()) abortedDownloads++;
+                metrics.failed.inc();
+                continue;
+            }
+            fetchedBytes += result.body.size();
+            metrics.fetched.inc();
+            metrics.bytes.inc(result.body.size());
+
+            fetchedQueue.push(FetchedPage{std::move(url), fp, std::move(result.effectiveUrl),
+                                          std::move(result.headers), std::time(nullptr), std::move(result.body)});
+        }
+    }
+
+    // ── Stage 2: link extraction, filtering, text + tokens (no shared locks) ──
+    void parseLoop() {
+        FetchedPage page;
+        while (fetchedQueue.wait_and_pop(page)) {
+            BusyScope busy(busyWorkers);
+            auto start = std::chrono::steady_clock::now();
+
+            // Wikipedia 404 check
+            if (page.html.find("Wikipedia does not have an article with this exact name") != std::string::npos) {
+                LOG_INFO("[Skipping] Broken Wikipedia link: " << page.url);
+                continue;
+            }
+
+            // Atomically claim the URL; a racing fetcher that got it too backs off here
+            if (!visitedURLs.insert(page.fingerprint)) continue;
+
+            // Resolve to the redirect target, overridden by <link rel="canonical">.
+            // Hrefs resolve against the URL as fetched (after redirects); the
+            // canonical form only keys dedup and aliases.
+            CanonicalUrl effective = UrlCanonicalizer::canonicalize(page.effectiveUrl);
+            std::string base = page.effectiveUrl.empty() ? page.url : page.effectiveUrl;
+            CanonicalUrl canonical = extractCanonical(page.html, base);
+            if (!canonical.valid) canonical = effective;
+
+            if (canonical.valid && canonical.fingerprint != page.fingerprint) {
+                recordAlias(page.fingerprint, canonical.fingerprint, canonical.url);
+                seenURLs.insert(canonical.fingerprint);       // Never enqueue the target separately
+                if (!visitedURLs.insert(canonical.fingerprint)) {
+                    duplicatesSkipped++;
+                    LOG_INFO("[Alias] " << page.url << " -> " << canonical.url << " (already indexed)");
+                    continue;
+                }
+                page.url = std::move(canonical.url);
+                page.fingerprint = canonical.fingerprint;
+            }
+
+            ParsedPage parsed;
+            parsed.words = Scraper::tokenize(Scraper::extractText(page.html));
+
+            // Mirrors and near-identical copies resolve to the first page indexed
+            if (config.detectNearDuplicates) {
+                NearDuplicateIndex::Match match;
+                parsed.simhash = nearDuplicates.signature(parsed.words);
+                if (nearDuplicates.findOrInsert(parsed.simhash, page.fingerprint, page.url, match)) {
+                    recordAlias(page.fingerprint, match.fingerprint, match.url);
+                    nearDuplicatesSkipped++;
+                    LOG_INFO("[NearDup] " << page.url << " ~ " << match.url << " (" << match.distance << " bits)");
+                    continue;
+                }
+            }
+            if (!claimPageSlot()) continue;
+            if (pageStore) pageStore->append(page.url, page.fetchedAt, page.headers, page.html);
+
+            parsed.url = std::move(page.url);
+            parsed.fingerprint = page.fingerprint;
+
+            auto links = extractCanonicalLinks(page.html, base);
+            for (auto& link : links) {
+                if (!config.linkFilter.accepts(link.url)) continue;
+                if (visitedURLs.contains(link.fingerprint)) continue;
+                if (config.respectRobots && !robots.allowedIfCached(link.url)) continue;
+
+                // Enqueue each URL at most once, however many pages link to it
+                if (seenURLs.insert(link.fingerprint)) scheduler.push(link.url);
+                parsed.links.push_back(std::move(link));
+            }
+            parseStats.record(start);
+
+            parsedQueue.push(std::move(parsed));
+        }
+    }
+
+    // ── Stage 3: graph + inverted index + trie updates ──
+    void indexLoop() {
+        ParsedPage page;
+        while (parsedQueue.wait_and_pop(page)) {
+            BusyScope busy(busyWorkers);
+            auto start = std::chrono::steady_clock::now();
+            documents.addDocument(page.fingerprint, page.url);
+
+            // Links to known aliases count towards the canonical page
+            std::vector<std::string> targets;
+            targets.reserve(page.links.size());
+            for (const auto& link : page.links) targets.push_back(documents.resolve(link.fingerprint, link.url));
+            {
+                std::lock_guard<std::mutex> lock(graphMutex);
+                for (const auto& target : targets) {
+                    linkGraph.addEdge(page.url, target);
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(indexMutex);
+                for (const auto& w : page.words) {
+                    invIndex.add(w, page.url);
+                    wordTrie.insert(w);
+                }
+            }
+            if (!config.checkpointDir.empty()) journalPage(page, targets);
+            indexStats.record(start);
+            metrics.indexed.inc();
+
+            LOG_INFO("[SUCCESS] Indexed (" << indexStats.processed << "/" << config.maxPages << "): " << page.url);
+            std::lock_guard<std::mutex> lock(logMutex);
+            visitedLog << page.url << "\n";
+        }
+    }
+
+    void journalPage(const ParsedPage& page, const std::vector<std::string>& targets) {
+        std::unordered_map<std::string, int> termFreq;
+        for (const auto& w : page.words) termFreq[w]++;
+
+        std::string block = "doc " + std::to_string(page.fingerprint) + " " + std::to_string(page.simhash) +
+                            " " + page.url + "\n";
+        for (const auto& target : targets) block += "edge " + page.url + " " + target + "\n";
+        for (const auto& tf : termFreq) {
+            block += "post " + tf.first + " " + page.url + " " + std::to_string(tf.second) + "\n";
+        }
+        appendJournal(block);
+    }
+
+    // Re-applies one WAL record. A crash between writing a segment and dropping
+    // the WAL generations it covers leaves pages in both; those are skipped.
+    bool replayRecord(const std::string& record) {
+        std::istringstream in(record);
+        std::string kind;
+        uint64_t fp = 0;
+        if (in >> kind >> fp && kind == "doc" && visitedURLs.contains(fp)) return false;
+
+        std::istringstream lines(record);
+        std::string line;
+        while (std::getline(lines, line)) replayLine(line);
+        return true;
+    }
+
+    // Re-applies one segment line (resume)
+    void replayLine(const std::string& line) {
+        std::istringstream in(line);
+        std::string kind;
+        in >> kind;
+        if (kind == "doc") {
+            uint64_t fp = 0, sig = 0;
+            std::string url;
+            if (!(in >> fp >> sig >> url)) return;
+            documents.addDocument(fp, url);
+            visitedURLs.insert(fp);
+            seenURLs.insert(fp);
+            NearDuplicateIndex::Match ignored;
+            nearDuplicates.findOrInsert(sig, fp, url, ignored);
+            processedCount++;
+        } else if (kind == "alias") {
+            uint64_t fp = 0, canonicalFp = 0;
+            std::string url;
+            if (!(in >> fp >> canonicalFp >> url)) return;
+            documents.addAlias(fp, canonicalFp, url);
+            visitedURLs.insert(fp);
+            seenURLs.insert(fp);
+        } else if (kind == "edge") {
+            std::string from, to;
+            if (!(in >> from >> to)) return;
+            linkGraph.addEdge(from, to);
+            replayedTargets.push_back(to);
+        } else if (kind == "post") {
+            std::string word, url;
+            int tf = 0;
+            if (!(in >> word >> url >> tf)) return;
+            invIndex.add(word, url, tf);
+            wordTrie.insert(word);
+        }
+    }
+
+public:
+    CrawlPipeline(const Config& cfg, InvertedIndex& index, Trie& trie, Graph& graph, std::ostream& visitedOut)
+        : config(cfg), invIndex(index), wordTrie(trie), linkGraph(graph), visitedLog(visitedOut),
+          scheduler(cfg.politeness), downloader(cfg.fetch),
+          robots(cfg.robots,
+                 [this](const std::string& url) {
+                     FetchResult r = downloader.fetchPage(url, robotsLimits());
+                     return RobotsCache::Response{r.status, std::move(r.body)};
+                 },
+                 [this](const std::string& host, double delay) { scheduler.setCrawlDelay(host, delay); }),
+          visitedURLs(visitedSetConfig()), nearDuplicates(cfg.nearDuplicates),
+          seenURLs(seenSetConfig(cfg)), fetchedQueue(cfg.fetchedQueueCapacity),
+          parsedQueue(cfg.parsedQueueCapacity), checkpoints(cfg.checkpointDir) {
+        config.linkFilter.prepare();
+        if (!cfg.checkpointDir.empty() && cfg.writeAheadLog) wal.reset(new WriteAheadLog(cfg.checkpointDir, cfg.wal));
+        if (!cfg.pageStorePath.empty()) {
+            pageStore.reset(new PageStore(cfg.pageStorePath));
+            if (!pageStore->isOpen()) pageStore.reset();
+        }
+    }
+
+    CrawlPipeline(const CrawlPipeline&) = delete;
+    CrawlPipeline& operator=(const CrawlPipeline&) = delete;
+
+    ~CrawlPipeline() { stop(); }
+
+    void seed(const std::string& url) {
+        CanonicalUrl clean = UrlCanonicalizer::canonicalize(url);
+        if (!clean.valid) return;
+        if (seenURLs.insert(clean.fingerprint)) scheduler.push(clean.url);
+    }
+
+    // Reloads documents, aliases, graph, postings and frontier from the last
+    // checkpoint, then replays the WAL written after it (call before start()).
+    // The frontier is the checkpointed one plus every unvisited link target, so
+    // URLs that were in flight when the process died are fetched again.
+    bool resume() {
+        if (config.checkpointDir.empty()) return false;
+        CrawlCheckpoint::State state;
+        bool haveState = checkpoints.exists() && checkpoints.loadState(state);
+        std::vector<uint64_t> walGenerations;
+        if (wal) walGenerations = WriteAheadLog::generations(config.checkpointDir);
+        if (!haveState && walGenerations.empty()) return false;
+
+        if (haveState) {
+            checkpoints.replay(state.segments, [this](const std::string& line) { replayLine(line); });
+            segmentCount = state.segments;
+        }
+        size_t walRecords = 0;
+        if (!walGenerations.empty()) {
+            // Replayed records go into the next segment; their WAL files are dropped after it
+            walRecords = WriteAheadLog::replay(config.checkpointDir, [this](const std::string& record) {
+                if (replayRecord(record)) journal += record;
+            });
+            walGeneration = walGenerations.back() + 1;
+        }
+
+        size_t requeued = 0;
+        for (const auto* urls : {&state.frontier, &replayedTargets}) {
+            for (const auto& url : *urls) {
+                uint64_t fp = fingerprint64(url);
+                if (visitedURLs.contains(fp) || !seenURLs.insert(fp)) continue;
+                scheduler.push(url);
+                requeued++;
+            }
+        }
+        replayedTargets.clear();
+        replayedTargets.shrink_to_fit();
+        resumed = true;
+
+        LOG_INFO("[Resume] " << documents.size() << " documents, " << documents.aliasCount() << " aliases, "
+                 << walRecords << " WAL records, " << requeued << " frontier URLs from " << config.checkpointDir);
+        return true;
+    }
+
+    // Writes what was indexed since the last checkpoint as a new segment, plus the frontier
+    bool checkpoint() {
+        if (config.checkpointDir.empty()) return false;
+        std::lock_guard<std::mutex> guard(checkpointMutex);
+        std::string segment;
+        uint64_t walCut = 0;
+        {
+            std::lock_guard<std::mutex> lock(journalMutex);
+            segment.swap(journal);
+            if (wal) walCut = wal->rotate();
+        }
+
+        CrawlCheckpoint::State state;
+        state.segments = segment.empty() ? segmentCount : segmentCount + 1;
+        state.frontier = scheduler.snapshot();
+        lastCheckpoint = std::chrono::steady_clock::now();
+
+        if (!checkpoints.save(state.segments, segment, state)) {
+            std::lock_guard<std::mutex> lock(journalMutex);
+            journal.insert(0, segment);                  // Retry with the next checkpoint
+            LOG_ERROR("[Checkpoint] Failed to write " << config.checkpointDir);
+            return false;
+        }
+        segmentCount = state.segments;
+        if (wal && !wal->removeBefore(walCut)) {     // Those records are in the segment now
+            LOG_WARN("[Checkpoint] Write-ahead log failed, older generations kept in " << config.checkpointDir);
+        }
+        LOG_INFO("[Checkpoint] segment " << segmentCount << " (" << segment.size() << " bytes), frontier "
+                 << state.frontier.size() << " URLs");
+        return true;
+    }
+
+    bool checkpointIfDue() {
+        if (config.checkpointDir.empty()) return false;
+        if (std::chrono::steady_clock::now() - lastCheckpoint < config.checkpointInterval) return false;
+        return checkpoint();
+    }
+
+    void start() {
+        crawling = true;
+        startedAt = std::chrono::steady_clock::now();
+        lastCheckpoint = startedAt;
+        if (!resumed && !config.checkpointDir.empty()) {
+            checkpoints.clear();                     // Leftovers of an earlier crawl must not be replayed
+            if (wal) wal->reset();
+        }
+        if (wal) wal->start(walGeneration);
+        for (int i = 0; i < config.indexThreads; ++i) indexers.emplace_back(&CrawlPipeline::indexLoop, this);
+        for (int i = 0; i < config.parseThreads; ++i) parsers.emplace_back(&CrawlPipeline::parseLoop, this);
+        for (int i = 0; i < config.fetchThreads; ++i) fetchers.emplace_back(&CrawlPipeline::fetchLoop, this);
+    }
+
+    // Stops fetching, then lets parse and index drain whatever is already queued
+    void stop() {
+        bool wasRunning = !fetchers.empty() || !parsers.empty() || !indexers.empty();
+        crawling = false;
+        scheduler.shutdown();
+        for (auto& t : fetchers) if (t.joinable()) t.join();
+        fetchedQueue.shutdown();
+        for (auto& t : parsers) if (t.joinable()) t.join();
+        parsedQueue.shutdown();
+        for (auto& t : indexers) if (t.joinable()) t.join();
+        fetchers.clear(); parsers.clear(); indexers.clear();
+        if (wasRunning) checkpoint();                    // Everything indexed is in the final segment
+        if (wal) wal->stop();
+    }
+
+    // Drops the checkpoint and WAL once the index they rebuild is saved (after stop())
+    void discardCheckpoint() {
+        if (config.checkpointDir.empty()) return;
+        checkpoints.clear();
+        if (wal) wal->reset();
+    }
+
+    bool isCrawling() const { return crawling; }
+
+    // Nothing queued or in flight in any stage: the frontier ran dry before
+    // maxPages. A page moving between stages can look idle for an instant, so
+    // callers should see it twice, some time apart, before giving up.
+    bool idle() const {
+        return busyWorkers == 0 && scheduler.size() == 0 && fetchedQueue.size() == 0 && parsedQueue.size() == 0;
+    }
+    int processed() const { return processedCount; }
+    size_t indexed() const { return indexStats.processed; }
+    const RobotsCache& robotsCache() const { return robots; }
+    const DocumentTable& documentTable() const { return documents; }
+    uint64_t duplicatesDropped() const { return duplicatesSkipped; }
+    uint64_t nearDuplicatesDropped() const { return nearDuplicatesSkipped; }
+    uint64_t downloadsAborted() const { return abortedDownloads; }
+    uint64_t bytesDownloaded() const { return fetchedBytes; }
+    MemoryUsage frontierMemory() const { return scheduler.memoryUsage(); }
+    const PageStore* pages() const { return pageStore.get(); }
+
+    const StageStats& fetchStage() const { return fetchStats; }
+    const StageStats& parseStage() const { return parseStats; }
+    const StageStats& indexStage() const { return indexStats; }
+
+    // One-line throughput summary per stage, written in one piece so it does
+    // not interleave with lines from the Logger thread
+    void printStatus(std::ostream& out) {
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+        if (secs <= 0) secs = 1e-9;
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1)
+            << "[Status] Processed: " << processedCount << " / " << config.maxPages
+            << " | fetch " << fetchStats.processed / secs << "/s (" << fetchStats.avgMillis() << " ms)"
+            << " | parse " << parseStats.processed / secs << "/s (" << parseStats.avgMillis() << " ms)"
+            << " | index " << indexStats.processed / secs << "/s (" << indexStats.avgMillis() << " ms)"
+            << " | queued: frontier " << scheduler.size()
+            << ", fetched " << fetchedQueue.size()
+            << ", parsed " << parsedQueue.size()
+            << " | robots blocked " << robots.blockedCount()
+            << " | aliases " << documents.aliasCount() << " (" << duplicatesSkipped << " dup skipped)"
+            << " | near-dups " << nearDuplicatesSkipped
+            << " | aborted downloads " << abortedDownloads << "\n";
+        out << line.str() << std::flush;
+    }
+};
+
+#endif
@@ -1,95 +1,215 @@
-#ifndef HTML_DOWNLOADER_H
-#define HTML_DOWNLOADER_H
-
-#include <string>
-#include <curl/curl.h>
-#include <iostream>
-
-class HTMLDownloader {
-private:
-    //  appends received data to string buffer
-    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
-        size_t totalSize = size * nmemb;
-        std::string* buffer = static_cast<std::string*>(userp);
-        buffer->append(static_cast<char*>(contents), totalSize);
-        return totalSize;
-    }
-
-public:
-    static std::string fetchHTML(const std::string& url) {
-        CURL* curl = curl_easy_init();
-        if (!curl) {
-            std::cerr << "[CURL ERROR] Failed to initialize curl for: " << url << "\n";
-            return "";
-        }
-
-        std::string buffer;
-
-        // Realistic browser User-Agent (Chrome on Windows - updated for late 2025)
-        const char* user_agent = 
-       "Mozilla/5.0 (Windows NT 10.0; Win64; x64) "
-       "AppleWebKit/537.36 (KHTML, like Gecko) "
-       "Chrome/143.0.0.0 Safari/537.36";
-        // Additional headers to mimic a real browser
-        struct curl_slist* headers = nullptr;
-        headers = curl_slist_append(headers, "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,image/apng,*/*;q=0.8");
-        headers = curl_slist_append(headers, "Accept-Language: en-US,en;q=0.9");
-        headers = curl_slist_append(headers, "Accept-Encoding: gzip, deflate, br");
-        headers = curl_slist_append(headers, "Upgrade-Insecure-Requests: 1");
-        headers = curl_slist_append(headers, "Sec-Fetch-Dest: document");
-        headers = curl_slist_append(headers, "Sec-Fetch-Mode: navigate");
-        headers = curl_slist_append(headers, "Sec-Fetch-Site: none");
-        headers = curl_slist_append(headers, "Sec-Fetch-User: ?1");
-
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buffer);
-        curl_easy_setopt(curl, CURLOPT_USERAGENT, user_agent);
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);          // Follow redirects
-        curl_easy_setopt(curl, CURLOPT_MAXREDIRS, 10L);
-        curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "gzip, deflate, br"); // Auto decompression
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 12L);                // Increased slightly
-        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 6L);
-        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);                // Thread-safe
-
-        // WARNING: Only for testing/dev! Re-enable in production!
-        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
-        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
-
-
-        CURLcode res = curl_easy_perform(curl);
-
-        // Clean up headers
-        curl_slist_free_all(headers);
-
-        if (res != CURLE_OK) {
-            std::cerr << "[CURL ERROR] " << curl_easy_strerror(res) << " for: " << url << "\n";
-            curl_easy_cleanup(curl);
-            return "";
-        }
-
-        long http_code = 0;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-
-        curl_easy_cleanup(curl);
-
-        if (http_code != 200) {
-            std::cerr << "[HTTP STATUS] " << http_code << " for: " << url << "\n";
-            if (http_code == 403 || http_code == 429 || http_code == 503) {
-                std::cerr << "[BLOCKED?] Possible anti-bot detection (403/429/503)\n";
-            }
-        }
-
-        if (buffer.empty()) {
-            std::cerr << "[EMPTY RESPONSE] No data received from: " << url << "\n";
-            return "";
-        }
-
-        std::cout << "[DOWNLOAD SUCCESS] " << buffer.length() << " bytes from: " << url << "\n";
-        return std::move(buffer);
-    }
-};
-
+#ifndef HTML_DOWNLOADER_H
+#define HTML_DOWNLOADER_H
+
+#include <string>
+#include <curl/curl.h>
+#include <cctype>
+#include <cstdlib>
+#include "../Logger/logger.h"
+
+// Cutoffs checked while a response streams in, so unwanted bodies are never downloaded
+struct DownloadLimits {
+    size_t maxBytes = 8 << 20;     // Decoded body size
+    bool htmlOnly = true;          // Reject anything but text/html and application/xhtml+xml
+};
+
+// Receive buffer of one transfer plus the limits it is checked against
+struct TransferBuffer {
+    std::string body;
+    DownloadLimits limits;
+    bool redirect = false;         // Current response is a 3xx that curl will follow
+    std::string headers;           // Status line + headers of the current response
+    std::string abortReason;       // Set when a callback cancels the transfer
+};
+
+// Outcome of one download. `effectiveUrl` is where redirects ended up.
+struct FetchResult {
+    std::string body;              // "" on failure
+    std::string effectiveUrl;
+    long status = 0;
+    std::string headers;           // Raw response headers (final response only)
+    std::string abortReason;       // Why the download was cut short, if it was
+
+    bool ok() const { return !body.empty(); }
+};
+
+class HTMLDownloader {
+private:
+    //  appends received data to string buffer
+    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+        size_t totalSize = size * nmemb;
+        TransferBuffer* buffer = static_cast<TransferBuffer*>(userp);
+        if (buffer->body.size() + totalSize > buffer->limits.maxBytes) {
+            buffer->abortReason = "body exceeds " + std::to_string(buffer->limits.maxBytes) + " bytes";
+            return 0;                                    // Makes curl fail with CURLE_WRITE_ERROR
+        }
+        buffer->body.append(static_cast<char*>(contents), totalSize);
+        return totalSize;
+    }
+
+    // Called once per header line; returning 0 aborts before any body is read
+    static size_t HeaderCallback(char* data, size_t size, size_t nitems, void* userp) {
+        size_t totalSize = size * nitems;
+        TransferBuffer* buffer = static_cast<TransferBuffer*>(userp);
+        std::string line(data, totalSize);
+        while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) line.pop_back();
+
+        // Status line of each response in a redirect chain
+        if (line.compare(0, 5, "HTTP/") == 0) {
+            size_t space = line.find(' ');
+            long code = space == std::string::npos ? 0 : std::atol(line.c_str() + space + 1);
+            buffer->redirect = code >= 300 && code < 400;
+            buffer->headers = line + "\r\n";
+            return totalSize;
+        }
+        if (buffer->redirect || line.empty()) return totalSize;
+
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) return totalSize;
+        std::string key = line.substr(0, colon);
+        std::string value = line.substr(colon + 1);
+        value.erase(0, value.find_first_not_of(" \t"));
+        for (auto& c : key) c = std::tolower(static_cast<unsigned char>(c));
+
+        // The body is kept decoded, so framing / encoding headers would no longer describe it
+        if (key != "content-encoding" && key != "transfer-encoding" && key != "content-length") {
+            buffer->headers += line + "\r\n";
+        }
+
+        if (key == "content-type" && buffer->limits.htmlOnly) {
+            std::string type = value.substr(0, value.find(';'));
+            for (auto& c : type) c = std::tolower(static_cast<unsigned char>(c));
+            type.erase(type.find_last_not_of(" \t") + 1);
+            if (type != "text/html" && type != "application/xhtml+xml") {
+                buffer->abortReason = "content-type " + type;
+                return 0;
+            }
+        } else if (key == "content-length") {
+            unsigned long long length = std::strtoull(value.c_str(), nullptr, 10);
+            if (length > buffer->limits.maxBytes) {
+                buffer->abortReason = "content-length " + std::to_string(length) + " exceeds " +
+                                      std::to_string(buffer->limits.maxBytes) + " bytes";
+                return 0;
+            }
+            buffer->body.reserve(static_cast<size_t>(length));   // Compressed size: a lower bound
+        }
+        return totalSize;
+    }
+
+public:
+    // Browser-like request headers shared by every transfer (caller frees with curl_slist_free_all)
+    static struct curl_slist* buildHeaders() {
+        struct curl_slist* headers = nullptr;
+        headers = curl_slist_append(headers, "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,image/apng,*/*;q=0.8");
+        headers = curl_slist_append(headers, "Accept-Language: en-US,en;q=0.9");
+        headers = curl_slist_append(headers, "Accept-Encoding: gzip, deflate, br");
+        headers = curl_slist_append(headers, "Upgrade-Insecure-Requests: 1");
+        headers = curl_slist_append(headers, "Sec-Fetch-Dest: document");
+        headers = curl_slist_append(headers, "Sec-Fetch-Mode: navigate");
+        headers = curl_slist_append(headers, "Sec-Fetch-Site: none");
+        headers = curl_slist_append(headers, "Sec-Fetch-User: ?1");
+        return headers;
+    }
+
+    // Applies the common options to an easy handle (used by fetchHTML and MultiplexDownloader)
+    static void configureHandle(CURL* curl, const std::string& url,
+                                TransferBuffer* buffer, struct curl_slist* headers) {
+        // Realistic browser User-Agent (Chrome on Windows - updated for late 2025)
+        const char* user_agent = 
+       "Mozilla/5.0 (Windows NT 10.0; Win64; x64) "
+       "AppleWebKit/537.36 (KHTML, like Gecko) "
+       "Chrome/143.0.0.0 Safari/537.36";
+
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, buffer);
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, HeaderCallback);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, buffer);
+        curl_easy_setopt(curl, CURLOPT_USERAGENT, user_agent);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+
+        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);          // Follow redirects
+        curl_easy_setopt(curl, CURLOPT_MAXREDIRS, 10L);
+        curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "gzip, deflate, br"); // Auto decompression
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 12L);                // Increased slightly
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 6L);
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);                // Thread-safe
+
+        // WARNING: Only for testing/dev! Re-enable in production!
+        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
+    }
+
+    // Logs the outcome of a finished transfer; returns the body or "" on failure
+    static std::string finishTransfer(CURL* curl, CURLcode res, const std::string& url,
+                                      TransferBuffer& buffer) {
+        if (!buffer.abortReason.empty()) {
+            LOG_WARN("[ABORTED] " << buffer.abortReason << " for: " << url);
+            return "";
+        }
+        if (res != CURLE_OK) {
+            LOG_WARN("[CURL ERROR] " << curl_easy_strerror(res) << " for: " << url);
+            return "";
+        }
+
+        long http_code = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+
+        if (http_code != 200) {
+            LOG_WARN("[HTTP STATUS] " << http_code << " for: " << url);
+            if (http_code == 403 || http_code == 429 || http_code == 503) {
+                LOG_WARN("[BLOCKED?] Possible anti-bot detection (403/429/503)");
+            }
+        }
+
+        if (buffer.body.empty()) {
+            LOG_WARN("[EMPTY RESPONSE] No data received from: " << url);
+            return "";
+        }
+
+        LOG_DEBUG("[DOWNLOAD SUCCESS] " << buffer.body.length() << " bytes from: " << url);
+        return std::move(buffer.body);
+    }
+
+    // finishTransfer plus the status code and final URL after redirects
+    static FetchResult finishFetch(CURL* curl, CURLcode res, const std::string& url,
+                                   TransferBuffer& buffer) {
+        FetchResult result;
+        result.body = finishTransfer(curl, res, url, buffer);
+        result.abortReason = buffer.abortReason;
+        result.headers = std::move(buffer.headers);
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &result.status);
+        char* effective = nullptr;
+        curl_easy_getinfo(curl, CURLINFO_EFFECTIVE_URL, &effective);
+        result.effectiveUrl = effective ? effective : url;
+        return result;
+    }
+
+    static FetchResult fetchPage(const std::string& url, const DownloadLimits& limits = DownloadLimits()) {
+        CURL* curl = curl_easy_init();
+        if (!curl) {
+            LOG_ERROR("[CURL ERROR] Failed to initialize curl for: " << url);
+            return FetchResult();
+        }
+
+        TransferBuffer buffer;
+        buffer.limits = limits;
+        struct curl_slist* headers = buildHeaders();
+        configureHandle(curl, url, &buffer, headers);
+
+        CURLcode res = curl_easy_perform(curl);
+
+        // Clean up headers
+        curl_slist_free_all(headers);
+
+        FetchResult result = finishFetch(curl, res, url, buffer);
+        curl_easy_cleanup(curl);
+        return result;
+    }
+
+    static std::string fetchHTML(const std::string& url) {
+        return fetchPage(url).body;
+    }
+};
+
 #endif 
\ No newline at end of file
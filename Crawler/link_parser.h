@@ -1,91 +1,131 @@
-#ifndef LINK_PARSER_H
-#define LINK_PARSER_H
-
-#include <regex>
-#include <string>
-#include <vector>
-#include <algorithm>
-#include <cctype>
-
-// 1. FIXED RESOLVE URL: This strictly prevents doubling URLs
-std::string resolveURL(const std::string& base, const std::string& link) {
-    if (link.empty()) return "";
-
-    // Trim whitespace
-    std::string cleanLink = link;
-    cleanLink.erase(0, cleanLink.find_first_not_of(" \t\r\n"));
-    cleanLink.erase(cleanLink.find_last_not_of(" \t\r\n") + 1);
-
-    if (cleanLink.empty()) return "";
-
-    // THE CRITICAL FIX: If it already looks like a URL, don't touch it!
-    if (cleanLink.find("://") != std::string::npos || cleanLink.find("http") == 0) {
-        return cleanLink;
-    }
-
-    // Handle protocol-relative (//en.wikipedia.org)
-    if (cleanLink.find("//") == 0) {
-        return "https:" + cleanLink;
-    }
-
-    // Handle absolute paths (/wiki/Page)
-    if (cleanLink[0] == '/') {
-        size_t schemeEnd = base.find("://");
-        if (schemeEnd == std::string::npos) return "";
-        size_t domainEnd = base.find('/', schemeEnd + 3);
-        std::string domain = (domainEnd != std::string::npos) ? base.substr(0, domainEnd) : base;
-        return domain + cleanLink;
-    }
-
-    // Handle relative paths
-    size_t lastSlash = base.rfind('/');
-    if (lastSlash != std::string::npos && lastSlash >= 8) {
-        return base.substr(0, lastSlash + 1) + cleanLink;
-    }
-
-    return base + "/" + cleanLink;
-}
-
-// 2. FIXED EXTRACT LINKS: Accepts two arguments to match your main.cpp
-std::vector<std::string> extractLinks(const std::string& html, const std::string& baseURL) {
-    std::vector<std::string> links;
-
-    std::regex linkRegex(
-        R"(\<a[^>]+href\s*=\s*(["']?)([^"'\s>]+)\1[^>]*\>)",
-        std::regex_constants::icase | std::regex_constants::optimize
-    );
-
-    auto begin = std::sregex_iterator(html.begin(), html.end(), linkRegex);
-    auto end = std::sregex_iterator();
-
-    for (auto i = begin; i != end; ++i) {
-        std::string link = (*i)[2].str();
-
-        // Filter junk
-        if (link.empty() || link[0] == '#' || link.find("javascript:") == 0 || 
-            link.find("mailto:") == 0) continue;
-
-        // Remove fragments
-        size_t frag = link.find('#');
-        if (frag != std::string::npos) link.erase(frag);
-
-        // Resolve path properly
-        std::string absolute = resolveURL(baseURL, link);
-        if (!absolute.empty()) {
-            links.push_back(absolute);
-        }
-    }
-
-    // Unique links only
-    std::sort(links.begin(), links.end());
-    links.erase(std::unique(links.begin(), links.end()), links.end());
-
-    return links;
-}
-
-// 3. OVERLOAD: Helps if you call it with only 1 argument elsewhere
-std::vector<std::string> extractLinks(const std::string& html) {
-    return extractLinks(html, "https://en.wikipedia.org");
-}
-
+#ifndef LINK_PARSER_H
+#define LINK_PARSER_H
+
+#include "url_canonicalizer.h"
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+
+// Scheme + host part of a URL ("https://en.wikipedia.org")
+std::string getDomain(const std::string& url) {
+    size_t pos = url.find("/", 8);
+    return (pos == std::string::npos) ? url : url.substr(0, pos);
+}
+
+// Absolute, canonical form of `link` as found on `base` ("" if not http(s))
+std::string resolveURL(const std::string& base, const std::string& link) {
+    CanonicalUrl resolved = UrlCanonicalizer::resolve(base, link);
+    return resolved.valid ? resolved.url : "";
+}
+
+// Every <a href> on the page, resolved and canonicalized once. Duplicates are
+// dropped by fingerprint, so "/wiki/X", "./X" and "/wiki/X#History" count once.
+std::vector<CanonicalUrl> extractCanonicalLinks(const std::string& html, const std::string& baseURL) {
+    std::vector<CanonicalUrl> links;
+
+    static const std::regex linkRegex(
+        R"(\<a[^>]+href\s*=\s*(["']?)([^"'\s>]+)\1[^>]*\>)",
+        std::regex_constants::icase | std::regex_constants::optimize
+    );
+
+    auto begin = std::sregex_iterator(html.begin(), html.end(), linkRegex);
+    auto end = std::sregex_iterator();
+
+    for (auto i = begin; i != end; ++i) {
+        std::string link = (*i)[2].str();
+
+        // Filter junk
+        if (link.empty() || link[0] == '#' || link.find("javascript:") == 0 || 
+            link.find("mailto:") == 0) continue;
+
+        CanonicalUrl absolute = UrlCanonicalizer::resolve(baseURL, link);
+        if (absolute.valid) {
+            links.push_back(std::move(absolute));
+        }
+    }
+
+    // Unique links only
+    std::sort(links.begin(), links.end(),
+              [](const CanonicalUrl& a, const CanonicalUrl& b) { return a.fingerprint < b.fingerprint; });
+    links.erase(std::unique(links.begin(), links.end(),
+                            [](const CanonicalUrl& a, const CanonicalUrl& b) { return a.fingerprint == b.fingerprint; }),
+                links.end());
+
+    return links;
+}
+
+// Same links as plain strings, sorted
+std::vector<std::string> extractLinks(const std::string& html, const std::string& baseURL) {
+    std::vector<std::string> links;
+    for (auto& link : extractCanonicalLinks(html, baseURL)) {
+        links.push_back(std::move(link.url));
+    }
+    std::sort(links.begin(), links.end());
+    return links;
+}
+
+// Value of attribute `name` (lowercase) in one tag, "" if absent. The name must
+// start the attribute, so "href" does not match inside "data-href".
+std::string tagAttribute(const std::string& tag, const std::string& name) {
+    std::string lowerTag = tag;
+    std::transform(lowerTag.begin(), lowerTag.end(), lowerTag.begin(), ::tolower);
+    for (size_t pos = lowerTag.find(name); pos != std::string::npos; pos = lowerTag.find(name, pos + 1)) {
+        if (pos == 0 || !std::isspace(static_cast<unsigned char>(lowerTag[pos - 1]))) continue;
+        size_t eq = lowerTag.find_first_not_of(" \t\r\n", pos + name.size());
+        if (eq == std::string::npos || lowerTag[eq] != '=') continue;
+        size_t valueStart = lowerTag.find_first_not_of(" \t\r\n", eq + 1);
+        if (valueStart == std::string::npos) return "";
+        char quote = tag[valueStart];
+        size_t valueEnd;
+        if (quote == '"' || quote == '\'') {
+            valueStart++;
+            valueEnd = tag.find(quote, valueStart);
+        } else {
+            valueEnd = tag.find_first_of(" \t\r\n", valueStart);
+        }
+        if (valueEnd == std::string::npos) valueEnd = tag.size();
+        return tag.substr(valueStart, valueEnd - valueStart);
+    }
+    return "";
+}
+
+// <link rel="canonical" href="..."> from the page head, resolved against `baseURL`.
+// Invalid if absent or if it points at another host (never trust cross-site claims).
+CanonicalUrl extractCanonical(const std::string& html, const std::string& baseURL) {
+    size_t headEnd = html.find("</head>");
+    if (headEnd == std::string::npos) headEnd = html.size();
+
+    for (size_t pos = html.find("<link", 0); pos < headEnd; pos = html.find("<link", pos + 5)) {
+        size_t tagEnd = html.find('>', pos);
+        if (tagEnd == std::string::npos) break;
+        std::string tag = html.substr(pos, tagEnd - pos);
+
+        // rel is a space-separated token list; "canonical" must be one of the tokens
+        std::string rel = tagAttribute(tag, "rel");
+        std::transform(rel.begin(), rel.end(), rel.begin(), ::tolower);
+        std::stringstream tokens(rel);
+        std::string token;
+        bool isCanonical = false;
+        while (tokens >> token) isCanonical = isCanonical || token == "canonical";
+        if (!isCanonical) continue;
+
+        std::string href = tagAttribute(tag, "href");
+        if (href.empty()) continue;
+
+        CanonicalUrl canonical = UrlCanonicalizer::resolve(baseURL, href);
+        CanonicalUrl base = UrlCanonicalizer::canonicalize(baseURL);
+        if (!canonical.valid || !base.valid || canonical.origin() != base.origin()) return CanonicalUrl();
+        return canonical;
+    }
+    return CanonicalUrl();
+}
+
+// 3. OVERLOAD: Helps if you call it with only 1 argument elsewhere
+std::vector<std::string> extractLinks(const std::string& html) {
+    return extractLinks(html, "https://en.wikipedia.org");
+}
+
 #endif
\ No newline at end of file
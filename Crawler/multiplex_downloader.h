@@ -0,0 +1,172 @@
+#ifndef MULTIPLEX_DOWNLOADER_H
+#define MULTIPLEX_DOWNLOADER_H
+
+#include "html_downloader.h"
+#include <curl/curl.h>
+#include <string>
+#include <deque>
+#include <set>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+// Drives one curl multi handle from a background thread. Every worker submits its
+// fetch here, so requests to the same host are multiplexed as HTTP/2 streams over
+// a handful of shared connections instead of opening one socket per download.
+class MultiplexDownloader {
+public:
+    struct Config {
+        long maxConnectionsPerHost = 2;    // Sockets kept open per host
+        long maxTotalConnections = 32;     // Connection cache size across all hosts
+        long maxConcurrentStreams = 100;   // HTTP/2 streams per connection
+        bool http2PriorKnowledge = false;  // h2c without Upgrade (local test servers, e.g. nghttpd)
+        DownloadLimits limits;             // Default content-type / size cutoffs per page
+    };
+
+private:
+    struct Transfer {
+        CURL* easy = nullptr;
+        struct curl_slist* headers = nullptr;
+        std::string url;
+        TransferBuffer buffer;
+        std::promise<FetchResult> result;
+    };
+
+    Config config;
+    CURLM* multi;
+
+    std::mutex pendingMtx;
+    std::deque<Transfer*> pending;             // Submitted, not yet added to the multi handle
+    std::set<Transfer*> inFlight;              // Owned by the event-loop thread
+    std::atomic<bool> running{true};
+    std::thread loop;
+
+    // Moves submitted transfers onto the multi handle (event-loop thread only)
+    void admitPending() {
+        std::deque<Transfer*> batch;
+        {
+            std::lock_guard<std::mutex> lock(pendingMtx);
+            batch.swap(pending);
+        }
+        for (Transfer* t : batch) {
+            t->easy = curl_easy_init();
+            if (!t->easy) {
+                LOG_ERROR("[CURL ERROR] Failed to initialize curl for: " << t->url);
+                complete(t, FetchResult());
+                continue;
+            }
+            t->headers = HTMLDownloader::buildHeaders();
+            HTMLDownloader::configureHandle(t->easy, t->url, &t->buffer, t->headers);
+            curl_easy_setopt(t->easy, CURLOPT_HTTP_VERSION,
+                             config.http2PriorKnowledge ? CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE
+                                                        : CURL_HTTP_VERSION_2TLS);
+            curl_easy_setopt(t->easy, CURLOPT_PIPEWAIT, 1L);  // Prefer waiting for a stream over a new socket
+            curl_easy_setopt(t->easy, CURLOPT_PRIVATE, t);
+            curl_multi_add_handle(multi, t->easy);
+            inFlight.insert(t);
+        }
+    }
+
+    void complete(Transfer* t, FetchResult result) {
+        t->result.set_value(std::move(result));
+        inFlight.erase(t);
+        if (t->easy) {
+            curl_multi_remove_handle(multi, t->easy);
+            curl_easy_cleanup(t->easy);
+        }
+        curl_slist_free_all(t->headers);
+        delete t;
+    }
+
+    void drainFinished() {
+        int queued = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi, &queued)) {
+            if (msg->msg != CURLMSG_DONE) continue;
+            Transfer* t = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &t);
+            FetchResult result = HTMLDownloader::finishFetch(t->easy, msg->data.result, t->url, t->buffer);
+            complete(t, std::move(result));
+        }
+    }
+
+    void run() {
+        int active = 0;
+        while (running) {
+            admitPending();
+            curl_multi_perform(multi, &active);
+            drainFinished();
+            curl_multi_poll(multi, nullptr, 0, 100, nullptr);  // Woken early by fetch()
+        }
+
+        // Shutdown: fail whatever is still in flight or waiting
+        {
+            std::lock_guard<std::mutex> lock(pendingMtx);
+            for (Transfer* t : pending) complete(t, FetchResult());
+            pending.clear();
+        }
+        while (!inFlight.empty()) {
+            complete(*inFlight.begin(), FetchResult());
+        }
+    }
+
+public:
+    MultiplexDownloader() : MultiplexDownloader(Config()) {}
+
+    explicit MultiplexDownloader(const Config& cfg) : config(cfg) {
+        multi = curl_multi_init();
+        curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, config.maxConnectionsPerHost);
+        curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, config.maxTotalConnections);
+        curl_multi_setopt(multi, CURLMOPT_MAX_CONCURRENT_STREAMS, config.maxConcurrentStreams);
+        loop = std::thread(&MultiplexDownloader::run, this);
+    }
+
+    MultiplexDownloader(const MultiplexDownloader&) = delete;
+    MultiplexDownloader& operator=(const MultiplexDownloader&) = delete;
+
+    ~MultiplexDownloader() {
+        running = false;
+        curl_multi_wakeup(multi);
+        if (loop.joinable()) loop.join();
+        curl_multi_cleanup(multi);
+    }
+
+    // Queues a download; the future yields an empty body on failure / shutdown
+    std::future<FetchResult> fetch(const std::string& url) {
+        return fetch(url, config.limits);
+    }
+
+    std::future<FetchResult> fetch(const std::string& url, const DownloadLimits& limits) {
+        Transfer* t = new Transfer();
+        t->url = url;
+        t->buffer.limits = limits;
+        std::future<FetchResult> f = t->result.get_future();
+        {
+            std::lock_guard<std::mutex> lock(pendingMtx);
+            if (!running) {
+                t->result.set_value(FetchResult());
+                delete t;
+                return f;
+            }
+            pending.push_back(t);
+        }
+        curl_multi_wakeup(multi);
+        return f;
+    }
+
+    // Blocking drop-ins for HTMLDownloader::fetchPage / fetchHTML
+    FetchResult fetchPage(const std::string& url) {
+        return fetch(url).get();
+    }
+
+    FetchResult fetchPage(const std::string& url, const DownloadLimits& limits) {
+        return fetch(url, limits).get();
+    }
+
+    std::string fetchHTML(const std::string& url) {
+        return fetch(url).get().body;
+    }
+};
+
+#endif
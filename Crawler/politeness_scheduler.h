@@ -0,0 +1,247 @@
+#ifndef POLITENESS_SCHEDULER_H
+#define POLITENESS_SCHEDULER_H
+
+#include "link_parser.h"
+#include "../Data_Structures/hashmap.h"
+#include "../Data_Structures/heap.h"
+#include "../Data_Structures/thread_safe_queue.h"
+#include <string>
+#include <deque>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// Per-host crawl frontier. Each host has its own URL queue and token bucket; hosts
+// with work wait in a min-heap keyed by the time they may next be fetched, so a
+// worker always gets the earliest eligible host instead of sleeping blindly.
+// Discovered links land in a lock-free intake ring first and are admitted to the
+// host queues in batches, so pushing 500 links per page never takes the mutex.
+class PolitenessScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Config {
+        std::chrono::milliseconds defaultDelay{250};  // Min spacing between requests to one host
+        double burst = 1.0;                           // Token bucket capacity (requests)
+        int maxConnectionsPerHost = 2;                // Concurrent fetches allowed per host
+        size_t intakeCapacity = 1 << 16;              // Lock-free ring between producers and scheduler
+    };
+
+private:
+    struct HostState {
+        std::deque<std::string> urls;
+        std::chrono::milliseconds delay{0};
+        double tokens = 0.0;
+        Clock::time_point lastRefill;
+        int inFlight = 0;
+        bool inHeap = false;
+    };
+
+    struct ReadyHost {
+        Clock::time_point when;
+        std::string host;
+        ReadyHost(Clock::time_point w = Clock::time_point(), const std::string& h = "") : when(w), host(h) {}
+    };
+
+    // MaxHeap with an inverted comparator keeps the earliest time on top
+    struct EarliestFirst {
+        bool operator()(const ReadyHost& a, const ReadyHost& b) const {
+            return a.when > b.when;
+        }
+    };
+
+    Config config;
+    HashMap<HostState> hosts;
+    MaxHeap<ReadyHost, EarliestFirst> ready;
+    ThreadSafeQueue<std::string> intake;
+    size_t queued = 0;
+    bool stopped = false;
+
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    std::atomic<int> waiting{0};
+
+    void refill(HostState& h, Clock::time_point now) const {
+        double elapsedMs = std::chrono::duration<double, std::milli>(now - h.lastRefill).count();
+        double rate = h.delay.count() > 0 ? 1.0 / h.delay.count() : 1e9;  // tokens per ms
+        h.tokens = std::min(config.burst, h.tokens + elapsedMs * rate);
+        h.lastRefill = now;
+    }
+
+    // Earliest moment the host's bucket holds a whole token
+    Clock::time_point eligibleAt(HostState& h, Clock::time_point now) const {
+        refill(h, now);
+        if (h.tokens >= 1.0 || h.delay.count() == 0) return now;
+        double waitMs = (1.0 - h.tokens) * h.delay.count();
+        return now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(waitMs));
+    }
+
+    HostState& hostFor(const std::string& host) {
+        if (!hosts.contains(host)) {
+            HostState fresh;
+            fresh.delay = config.defaultDelay;
+            fresh.tokens = config.burst;
+            fresh.lastRefill = Clock::now();
+            hosts.put(host, fresh);
+        }
+        return hosts[host];
+    }
+
+    void admit(std::string url, Clock::time_point now) {
+        std::string host = getDomain(url);
+        HostState& h = hostFor(host);
+        h.urls.push_back(std::move(url));
+        queued++;
+        schedule(host, h, now);
+    }
+
+    // Moves everything waiting in the intake ring onto the host queues (mutex held)
+    void drainIntake(Clock::time_point now) {
+        std::string url;
+        while (intake.try_pop(url)) {
+            admit(std::move(url), now);
+        }
+    }
+
+    // Puts the host back in the heap if it has work and a free connection slot
+    void schedule(const std::string& host, HostState& h, Clock::time_point now) {
+        if (h.inHeap || h.urls.empty() || h.inFlight >= config.maxConnectionsPerHost) return;
+        h.inHeap = true;
+        ready.push(ReadyHost(eligibleAt(h, now), host));
+        cv.notify_one();
+    }
+
+public:
+    PolitenessScheduler() : PolitenessScheduler(Config()) {}
+    explicit PolitenessScheduler(const Config& cfg) : config(cfg), intake(cfg.intakeCapacity) {}
+
+    PolitenessScheduler(const PolitenessScheduler&) = delete;
+    PolitenessScheduler& operator=(const PolitenessScheduler&) = delete;
+
+    void push(std::string url) {
+        if (!intake.try_push(std::move(url))) {
+            // Ring full: admit directly rather than drop or block the producer
+            std::lock_guard<std::mutex> lock(mtx);
+            if (stopped) return;
+            admit(std::move(url), Clock::now());
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mtx);
+            cv.notify_one();
+        }
+    }
+
+    // Blocks until some host may be fetched (or timeout / shutdown). The caller
+    // owns a connection slot for that host until it calls release(url).
+    bool next(std::string& url, std::chrono::milliseconds timeout) {
+        auto deadline = Clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(mtx);
+        while (!stopped) {
+            auto now = Clock::now();
+            drainIntake(now);
+            if (!ready.empty()) {
+                ReadyHost top = ready.top();
+                if (top.when <= now) {
+                    ready.pop();
+                    HostState& h = hosts[top.host];
+                    h.inHeap = false;
+
+                    // Crawl-delay may have changed since this entry was queued
+                    auto when = eligibleAt(h, now);
+                    if (when > now) {
+                        h.inHeap = true;
+                        ready.push(ReadyHost(when, top.host));
+                        continue;
+                    }
+
+                    url = std::move(h.urls.front());
+                    h.urls.pop_front();
+                    queued--;
+                    h.tokens -= 1.0;
+                    h.inFlight++;
+                    schedule(top.host, h, now);
+                    return true;
+                }
+            }
+            if (now >= deadline) return false;
+
+            auto wakeAt = ready.empty() ? deadline : std::min(deadline, ready.top().when);
+            waiting.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (intake.empty()) cv.wait_until(lock, wakeAt);
+            waiting.fetch_sub(1);
+        }
+        return false;
+    }
+
+    // Frees the connection slot taken by next()
+    void release(const std::string& url) {
+        std::string host = getDomain(url);
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!hosts.contains(host)) return;
+        HostState& h = hosts[host];
+        if (h.inFlight > 0) h.inFlight--;
+        schedule(host, h, Clock::now());
+    }
+
+    // Applies a robots.txt Crawl-delay (seconds); never faster than the default
+    void setCrawlDelay(const std::string& host, double seconds) {
+        std::lock_guard<std::mutex> lock(mtx);
+        HostState& h = hostFor(host);
+        auto requested = std::chrono::milliseconds(static_cast<long long>(seconds * 1000.0));
+        h.delay = std::max(config.defaultDelay, requested);
+    }
+
+    // Copy of every queued URL, for checkpoints; the queues are left as they are
+    std::vector<std::string> snapshot() {
+        std::lock_guard<std::mutex> lock(mtx);
+        drainIntake(Clock::now());
+        std::vector<std::string> urls;
+        urls.reserve(queued);
+        for (const auto& host : hosts.getKeys()) {
+            const HostState& h = hosts[host];
+            urls.insert(urls.end(), h.urls.begin(), h.urls.end());
+        }
+        return urls;
+    }
+
+    // Wakes every waiting worker; next() returns false from now on
+    void shutdown() {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopped = true;
+        intake.shutdown();
+        cv.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return queued + intake.size();
+    }
+
+    // Hosts are keys, queued URLs values; the overhead is the host table, deque
+    // blocks (libstdc++: 512 bytes, 16 strings each), the ready heap and the
+    // intake ring. URLs still in the ring are counted once admitted.
+    MemoryUsage memoryUsage() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        MemoryUsage usage;
+        usage.overhead += sizeof(hosts) + ready.size() * sizeof(ReadyHost);
+        usage.overhead += intake.capacity() * (sizeof(std::atomic<size_t>) + sizeof(std::string));
+        hosts.forEach([&usage](const std::string& host, const HostState& h) {
+            usage.keys += sizeof(host) + MemoryUsage::heap(host);
+            usage.overhead += MemoryUsage::chunk(sizeof(std::pair<std::string, HostState>) + sizeof(void*)) - sizeof(host);
+            for (const auto& url : h.urls) addMemory(usage, url);
+            size_t blocks = h.urls.size() / 16 + 1;
+            usage.overhead += blocks * MemoryUsage::chunk(512) + MemoryUsage::chunk(8 * sizeof(void*))
+                              - h.urls.size() * sizeof(std::string);
+            usage.entries += h.urls.size();
+        });
+        return usage;
+    }
+};
+
+#endif
@@ -0,0 +1,326 @@
+#ifndef ROBOTS_H
+#define ROBOTS_H
+
+#include "link_parser.h"
+#include "../Data_Structures/hashmap.h"
+#include "../Metrics/metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// robots.txt rules for one host, compiled into a character trie. '*' becomes a
+// self-looping wildcard node and '$' an end-of-path marker, so checking a path
+// is a single left-to-right walk instead of testing every rule separately.
+// Precedence follows RFC 9309: the longest matching rule wins, Allow on ties.
+class RobotsRules {
+private:
+    struct Node {
+        std::vector<std::pair<char, int>> next;   // Literal edges (sorted by char)
+        int star = -1;                            // '*' edge
+        bool wildcard = false;                    // Reached through '*': loops on any char
+        int prefixRule = -1;                      // Rule length ending here (prefix match)
+        bool prefixAllow = false;
+        int exactRule = -1;                       // Rule length ending here with '$'
+        bool exactAllow = false;
+    };
+
+    std::vector<Node> nodes;
+    double crawlDelay = 0.0;
+
+    int child(int n, char c) const {
+        const auto& edges = nodes[n].next;
+        auto it = std::lower_bound(edges.begin(), edges.end(), std::make_pair(c, -1));
+        return (it != edges.end() && it->first == c) ? it->second : -1;
+    }
+
+    int addChild(int n, char c) {
+        int existing = child(n, c);
+        if (existing != -1) return existing;
+        nodes.emplace_back();
+        int id = static_cast<int>(nodes.size()) - 1;
+        auto& edges = nodes[n].next;
+        edges.insert(std::lower_bound(edges.begin(), edges.end(), std::make_pair(c, -1)), std::make_pair(c, id));
+        return id;
+    }
+
+    static void mark(int& len, bool& allow, int ruleLen, bool ruleAllow) {
+        if (ruleLen > len || (ruleLen == len && ruleAllow)) {
+            len = ruleLen;
+            allow = ruleAllow;
+        }
+    }
+
+    // Adds n and everything reachable through '*' edges (which may match nothing).
+    // The active set stays tiny (one literal path plus open wildcards), so a linear
+    // duplicate check beats allocating a visited array per lookup.
+    void addState(std::vector<int>& states, int n) const {
+        while (n != -1 && std::find(states.begin(), states.end(), n) == states.end()) {
+            states.push_back(n);
+            n = nodes[n].star;
+        }
+    }
+
+public:
+    RobotsRules() { nodes.emplace_back(); }
+
+    void addRule(const std::string& pattern, bool allow) {
+        if (pattern.empty()) return;               // "Disallow:" with no path allows everything
+        int n = 0;
+        int len = static_cast<int>(pattern.size());
+        bool anchored = pattern.back() == '$';
+        size_t end = anchored ? pattern.size() - 1 : pattern.size();
+        for (size_t i = 0; i < end; ++i) {
+            if (pattern[i] == '*') {
+                if (nodes[n].star == -1) {
+                    nodes.emplace_back();
+                    int id = static_cast<int>(nodes.size()) - 1;
+                    nodes[id].wildcard = true;
+                    nodes[n].star = id;
+                }
+                n = nodes[n].star;
+                while (i + 1 < end && pattern[i + 1] == '*') ++i;  // "**" == "*"
+            } else {
+                n = addChild(n, pattern[i]);
+            }
+        }
+        if (anchored) mark(nodes[n].exactRule, nodes[n].exactAllow, len, allow);
+        else mark(nodes[n].prefixRule, nodes[n].prefixAllow, len, allow);
+    }
+
+    // `path` is everything after the host, including the query ("/wiki/X?a=b")
+    bool allowed(const std::string& path) const {
+        if (nodes.size() == 1) return true;
+
+        int bestLen = -1;
+        bool bestAllow = true;
+        std::vector<int> current, next;
+        addState(current, 0);
+
+        for (size_t i = 0; i <= path.size() && !current.empty(); ++i) {
+            for (int n : current) {
+                const Node& node = nodes[n];
+                if (node.prefixRule >= 0) mark(bestLen, bestAllow, node.prefixRule, node.prefixAllow);
+                if (i == path.size() && node.exactRule >= 0) mark(bestLen, bestAllow, node.exactRule, node.exactAllow);
+            }
+            if (i == path.size()) break;
+
+            next.clear();
+            for (int n : current) {
+                if (nodes[n].wildcard) addState(next, n);  // '*' consumes this char
+                addState(next, child(n, path[i]));
+            }
+            current.swap(next);
+        }
+        return bestLen < 0 || bestAllow;
+    }
+
+    double getCrawlDelay() const { return crawlDelay; }
+
+    // Blocks every path (robots.txt unreachable or answering 5xx)
+    static RobotsRules disallowAll() {
+        RobotsRules r;
+        r.addRule("/", false);
+        return r;
+    }
+
+    // Lowercased product token: "atmx" for "atmx/1.0" or " ATMX"
+    static std::string productToken(const std::string& agent) {
+        std::string token;
+        size_t i = agent.find_first_not_of(" \t");
+        for (; i < agent.size(); ++i) {
+            char c = agent[i];
+            if (!std::isalpha(static_cast<unsigned char>(c)) && c != '_' && c != '-') break;
+            token += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return token;
+    }
+
+    // Parses robots.txt and keeps the group whose user-agent equals our product
+    // token, case-insensitively (falls back to "*")
+    static RobotsRules parse(const std::string& content, const std::string& agent) {
+        const std::string token = productToken(agent);
+
+        RobotsRules specific, wildcard;
+        bool haveSpecific = false;
+        bool inSpecific = false, inWildcard = false;
+        bool lastWasAgent = false;
+
+        std::stringstream ss(content);
+        std::string line;
+        while (std::getline(ss, line)) {
+            size_t hash = line.find('#');
+            if (hash != std::string::npos) line.erase(hash);
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) continue;
+
+            std::string key = line.substr(0, colon);
+            std::string value = line.substr(colon + 1);
+            key.erase(0, key.find_first_not_of(" \t"));
+            key.erase(key.find_last_not_of(" \t\r") + 1);
+            value.erase(0, value.find_first_not_of(" \t"));
+            value.erase(value.find_last_not_of(" \t\r") + 1);
+            std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+
+            if (key == "user-agent") {
+                if (!lastWasAgent) inSpecific = inWildcard = false;  // New group starts
+                if (value == "*") inWildcard = true;
+                else if (!token.empty() && productToken(value) == token) inSpecific = haveSpecific = true;
+                lastWasAgent = true;
+                continue;
+            }
+            lastWasAgent = false;
+
+            if (key == "allow" || key == "disallow") {
+                bool allow = key == "allow";
+                if (inSpecific) specific.addRule(value, allow);
+                if (inWildcard) wildcard.addRule(value, allow);
+            } else if (key == "crawl-delay") {
+                double d = std::atof(value.c_str());
+                if (inSpecific) specific.crawlDelay = d;
+                if (inWildcard) wildcard.crawlDelay = d;
+            }
+        }
+        return haveSpecific ? specific : wildcard;
+    }
+};
+
+// Per-host cache of compiled robots.txt rules. The first URL seen for a host
+// triggers the download; concurrent callers for the same host wait for it
+// instead of fetching twice. Entries are refreshed after `ttl`.
+//
+// Status handling follows RFC 9309: 2xx is parsed, any other 3xx / 4xx means
+// there is no robots.txt (allow all), 5xx or no response at all disallows the
+// whole host, but only for `errorTtl` before the fetch is retried.
+class RobotsCache {
+public:
+    struct Response {
+        long status = 0;                 // 0: host unreachable
+        std::string body;
+    };
+
+    using Fetcher = std::function<Response(const std::string&)>;
+    using DelayCallback = std::function<void(const std::string& host, double seconds)>;
+
+    struct Config {
+        std::string userAgent = "atmx";
+        std::chrono::seconds ttl{24 * 3600};
+        std::chrono::seconds errorTtl{5 * 60};      // Unreachable / 5xx: retry this soon
+    };
+
+private:
+    struct Entry {
+        std::shared_ptr<const RobotsRules> rules;
+        std::chrono::steady_clock::time_point fetchedAt;
+        std::chrono::seconds ttl{0};
+        bool pending = false;
+    };
+
+    Config config;
+    Fetcher fetcher;
+    DelayCallback onCrawlDelay;
+    HashMap<Entry> entries;
+    std::mutex mtx;
+    std::condition_variable ready;
+
+    std::atomic<uint64_t> hits{0}, misses{0}, blocked{0};
+    MetricCounter& hitMetric = MetricsRegistry::global().counter(
+        "atmx_robots_cache_lookups_total", "robots.txt cache lookups by result", "result=\"hit\"");
+    MetricCounter& missMetric = MetricsRegistry::global().counter(
+        "atmx_robots_cache_lookups_total", "robots.txt cache lookups by result", "result=\"miss\"");
+
+    static std::string pathOf(const std::string& url, const std::string& host) {
+        std::string path = url.substr(host.length());
+        return path.empty() ? "/" : path;
+    }
+
+    std::shared_ptr<const RobotsRules> rulesFor(const std::string& host) {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true) {
+            if (entries.contains(host)) {
+                Entry& e = entries[host];
+                if (e.pending) {
+                    ready.wait(lock);
+                    continue;
+                }
+                if (std::chrono::steady_clock::now() - e.fetchedAt < e.ttl) {
+                    hits++;
+                    hitMetric.inc();
+                    return e.rules;
+                }
+            }
+            entries[host].pending = true;
+            break;
+        }
+        misses++;
+        missMetric.inc();
+        lock.unlock();
+
+        Response response = fetcher(host + "/robots.txt");
+        std::shared_ptr<const RobotsRules> rules;
+        std::chrono::seconds ttl = config.ttl;
+        if (response.status >= 200 && response.status < 300) {
+            rules = std::make_shared<const RobotsRules>(RobotsRules::parse(response.body, config.userAgent));
+        } else if (response.status >= 300 && response.status < 500) {
+            rules = std::make_shared<const RobotsRules>();
+        } else {
+            rules = std::make_shared<const RobotsRules>(RobotsRules::disallowAll());
+            ttl = config.errorTtl;                   // One network error must not block the host for a day
+        }
+        if (onCrawlDelay && rules->getCrawlDelay() > 0) onCrawlDelay(host, rules->getCrawlDelay());
+
+        lock.lock();
+        Entry& e = entries[host];
+        e.rules = rules;
+        e.fetchedAt = std::chrono::steady_clock::now();
+        e.ttl = ttl;
+        e.pending = false;
+        ready.notify_all();
+        return rules;
+    }
+
+public:
+    RobotsCache(const Config& cfg, Fetcher fetch, DelayCallback delayCallback = nullptr)
+        : config(cfg), fetcher(std::move(fetch)), onCrawlDelay(std::move(delayCallback)) {}
+
+    // Fetches robots.txt on first use of the host (call from the fetch stage)
+    bool allowed(const std::string& url) {
+        std::string host = getDomain(url);
+        bool ok = rulesFor(host)->allowed(pathOf(url, host));
+        if (!ok) blocked++;
+        return ok;
+    }
+
+    // Never fetches: hosts not cached yet are allowed and re-checked at fetch time
+    bool allowedIfCached(const std::string& url) {
+        std::string host = getDomain(url);
+        std::shared_ptr<const RobotsRules> rules;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!entries.contains(host)) return true;
+            const Entry& e = entries[host];
+            if (e.pending || !e.rules) return true;
+            rules = e.rules;
+        }
+        hits++;
+        hitMetric.inc();
+        bool ok = rules->allowed(pathOf(url, host));
+        if (!ok) blocked++;
+        return ok;
+    }
+
+    uint64_t cacheHits() const { return hits; }
+    uint64_t cacheMisses() const { return misses; }
+    uint64_t blockedCount() const { return blocked; }
+};
+
+#endif
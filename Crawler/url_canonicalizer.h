@@ -0,0 +1,254 @@
+#ifndef URL_CANONICALIZER_H
+#define URL_CANONICALIZER_H
+
+#include "../Data_Structures/fingerprint.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Canonical form of a crawlable URL plus its 64-bit fingerprint. Everything that
+// dedups or looks URLs up (visited set, frontier filter, document table) keys on
+// `fingerprint`, so spelling variants of one page collapse to one entry.
+struct CanonicalUrl {
+    std::string url;             // scheme://host[:port]/path[?query]
+    uint64_t fingerprint = 0;
+    size_t originLength = 0;     // url.substr(0, originLength) == "scheme://host[:port]"
+    bool valid = false;
+
+    std::string origin() const { return url.substr(0, originLength); }
+};
+
+// RFC 3986 normalization, done in one parse:
+//   * lowercase scheme and host, drop userinfo, default ports and the fragment
+//   * decode percent-escapes of unreserved characters, uppercase the rest,
+//     escape bytes that may not appear raw (spaces, non-ASCII, quotes...)
+//   * remove "." / ".." segments, "" path -> "/", drop a bare trailing '?'
+// A trailing '/' is kept: "/docs/" and "/docs" are different resources, and
+// the canonical URL is also the base relative links resolve against.
+// It also repairs the doubled "https://host/https://host/..." links that the
+// old resolver produced.
+class UrlCanonicalizer {
+private:
+    struct Parts {
+        std::string scheme, host, port, path, query;
+        bool hasAuthority = false;
+        bool hasQuery = false;
+    };
+
+    static bool isAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+    static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+    static char lower(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + 32) : c; }
+
+    static int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    static bool isUnreserved(unsigned char c) {
+        return isAlpha(c) || isDigit(c) || c == '-' || c == '.' || c == '_' || c == '~';
+    }
+
+    // Characters that may stay literal in a path (pchar + '/') or query (+ '?')
+    static bool isAllowedRaw(unsigned char c, bool inQuery) {
+        if (isUnreserved(c)) return true;
+        switch (c) {
+            case '!': case '$': case '&': case '\'': case '(': case ')':
+            case '*': case '+': case ',': case ';': case '=':
+            case ':': case '@': case '/':
+                return true;
+            case '?':
+                return inQuery;
+            default:
+                return false;
+        }
+    }
+
+    static void appendEscaped(std::string& out, unsigned char c) {
+        static const char* hex = "0123456789ABCDEF";
+        out += '%';
+        out += hex[c >> 4];
+        out += hex[c & 15];
+    }
+
+    static void normalizeEscapes(const std::string& in, bool inQuery, std::string& out) {
+        out.reserve(out.size() + in.size());
+        for (size_t i = 0; i < in.size(); ++i) {
+            unsigned char c = static_cast<unsigned char>(in[i]);
+            if (c == '%' && i + 2 < in.size() &&hexValue(in[i + 1]) >= 0 && hexValue(in[i + 2]) >= 0) {
+                unsigned char decoded = static_cast<unsigned char>(hexValue(in[i + 1]) * 16 + hexValue(in[i + 2]));
+                if (isUnreserved(decoded)) out += static_cast<char>(decoded);
+                else appendEscaped(out, decoded);
+                i += 2;
+            } else if (isAllowedRaw(c, inQuery)) {
+                out += static_cast<char>(c);
+            } else {
+                appendEscaped(out, c);
+            }
+        }
+    }
+
+    // RFC 3986 section 5.2.4
+    static std::string removeDotSegments(const std::string& path) {
+        std::vector<std::string> segments;
+        size_t i = 0;
+        bool trailingSlash = false;
+        while (i < path.size()) {
+            size_t next = path.find('/', i + 1);
+            if (next == std::string::npos) next = path.size();
+            std::string seg = path.substr(i + 1, next - i - 1);   // Skips the leading '/'
+            trailingSlash = (seg == "." || seg == "..");
+            if (seg == "..") {
+                if (!segments.empty()) segments.pop_back();
+            } else if (seg != ".") {
+                segments.push_back(seg);
+            }
+            i = next;
+        }
+        std::string out;
+        for (const auto& seg : segments) {
+            out += '/';
+            out += seg;
+        }
+        if (trailingSlash || out.empty()) out += '/';
+        return out;
+    }
+
+    static bool parse(const std::string& raw, Parts& p) {
+        size_t begin = raw.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos) return false;
+        size_t end = raw.find_last_not_of(" \t\r\n") + 1;
+        std::string s = raw.substr(begin, end - begin);
+
+        // Repair doubled links ("https://a.org/wiki/https://a.org/wiki/X"): only when
+        // the path repeats our own scheme + host, so URLs that legitimately embed
+        // another one ("https://web.archive.org/web/2020/https://b.org/") survive
+        size_t first = s.find("://");
+        size_t doubled = first == std::string::npos ? first : s.find("://", first + 3);
+        if (doubled != std::string::npos) {
+            size_t schemeStart = doubled;
+            while (schemeStart > 0 && isAlpha(s[schemeStart - 1])) --schemeStart;
+            size_t outerEnd = s.find('/', first + 3);
+            size_t innerEnd = s.find('/', doubled + 3);
+            if (innerEnd == std::string::npos) innerEnd = s.size();
+            if (schemeStart > 0 && s[schemeStart - 1] == '/' && outerEnd < schemeStart &&
+                innerEnd - schemeStart == outerEnd) {
+                bool sameOrigin = true;
+                for (size_t i = 0; i < outerEnd && sameOrigin; ++i) sameOrigin = lower(s[i]) == lower(s[schemeStart + i]);
+                if (sameOrigin) s = s.substr(schemeStart);
+            }
+        }
+
+        size_t hash = s.find('#');
+        if (hash != std::string::npos) s.erase(hash);
+
+        size_t pos = 0;
+        size_t colon = s.find(':');
+        if (colon != std::string::npos && colon > 0 && isAlpha(s[0])) {
+            bool schemeOk = true;
+            for (size_t i = 0; i < colon; ++i) {
+                char c = s[i];
+                if (!(isAlpha(c) || isDigit(c) || c == '+' || c == '-' || c == '.')) { schemeOk = false; break; }
+            }
+            if (schemeOk) {
+                for (size_t i = 0; i < colon; ++i) p.scheme += lower(s[i]);
+                pos = colon + 1;
+            }
+        }
+
+        if (s.compare(pos, 2, "//") == 0) {
+            p.hasAuthority = true;
+            pos += 2;
+            size_t authEnd = s.find_first_of("/?", pos);
+            if (authEnd == std::string::npos) authEnd = s.size();
+            std::string authority = s.substr(pos, authEnd - pos);
+            size_t at = authority.rfind('@');
+            if (at != std::string::npos) authority.erase(0, at + 1);
+            size_t portSep = authority.rfind(':');
+            if (portSep != std::string::npos && authority.find(']', portSep) == std::string::npos) {
+                p.port = authority.substr(portSep + 1);
+                authority.erase(portSep);
+            }
+            for (char c : authority) p.host += lower(c);
+            while (!p.host.empty() && p.host.back() == '.') p.host.pop_back();
+            pos = authEnd;
+        }
+
+        size_t q = s.find('?', pos);
+        if (q == std::string::npos) {
+            p.path = s.substr(pos);
+        } else {
+            p.path = s.substr(pos, q - pos);
+            p.query = s.substr(q + 1);
+            p.hasQuery = true;
+        }
+        return true;
+    }
+
+    static CanonicalUrl build(Parts& p) {
+        CanonicalUrl out;
+        if (p.scheme != "http" && p.scheme != "https") return out;
+        if (p.host.empty()) return out;
+        for (char c : p.port) if (!isDigit(c)) return out;
+        if ((p.scheme == "http" && p.port == "80") || (p.scheme == "https" && p.port == "443")) p.port.clear();
+
+        out.url.reserve(p.scheme.size() + p.host.size() + p.path.size() + p.query.size() + 16);
+        out.url += p.scheme;
+        out.url += "://";
+        out.url += p.host;
+        if (!p.port.empty()) {
+            out.url += ':';
+            out.url += p.port;
+        }
+        out.originLength = out.url.size();
+
+        std::string path;
+        normalizeEscapes(p.path.empty() ? std::string("/") : p.path, false, path);
+        out.url += removeDotSegments(path);
+
+        if (p.hasQuery && !p.query.empty()) {
+            out.url += '?';
+            normalizeEscapes(p.query, true, out.url);
+        }
+
+        out.fingerprint = fingerprint64(out.url);
+        out.valid = true;
+        return out;
+    }
+
+public:
+    static CanonicalUrl canonicalize(const std::string& raw) {
+        Parts p;
+        if (!parse(raw, p)) return CanonicalUrl();
+        return build(p);
+    }
+
+    // Resolves an href found on `base` (RFC 3986 section 5.2) and canonicalizes it
+    static CanonicalUrl resolve(const std::string& base, const std::string& ref) {
+        Parts r;
+        if (!parse(ref, r)) return CanonicalUrl();
+        if (!r.scheme.empty()) return build(r);
+
+        Parts b;
+        if (!parse(base, b) || b.scheme.empty()) return CanonicalUrl();
+        r.scheme = b.scheme;
+        if (r.hasAuthority) return build(r);
+
+        r.host = b.host;
+        r.port = b.port;
+        if (r.path.empty()) {
+            r.path = b.path;
+            if (!r.hasQuery) {
+                r.query = b.query;
+                r.hasQuery = b.hasQuery;
+            }
+        } else if (r.path[0] != '/') {
+            size_t slash = b.path.rfind('/');
+            r.path = (slash == std::string::npos ? std::string("/") : b.path.substr(0, slash + 1)) + r.path;
+        }
+        return build(r);
+    }
+};
+
+#endif
@@ -0,0 +1,208 @@
+#ifndef URL_FILTER_H
+#define URL_FILTER_H
+
+#include "../Logger/logger.h"
+#include <atomic>
+#include <cctype>
+#include <fstream>
+#include <initializer_list>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Include/exclude rules for discovered links, compiled into one Aho-Corasick
+// automaton (a full 256-column DFA). classify() walks the URL once, lowercasing
+// on the fly, and every rule — prefix, substring or extension — is decided by
+// where its pattern match starts or ends. No per-rule find() calls, no copies.
+class UrlFilter {
+public:
+    enum RuleKind {
+        INCLUDE_PREFIX,      // If any exist, the URL must start with one of them
+        EXCLUDE_PREFIX,
+        EXCLUDE_SUBSTRING,
+        EXCLUDE_EXTENSION    // Path (before '?' / '#') ends with it, e.g. ".pdf"
+    };
+
+    enum Verdict {
+        ACCEPTED,
+        NOT_INCLUDED,
+        EXCLUDED_PREFIX,
+        EXCLUDED_SUBSTRING,
+        EXCLUDED_EXTENSION
+    };
+
+private:
+    struct Rule {
+        std::string pattern;
+        RuleKind kind;
+    };
+
+    std::vector<Rule> rules;
+    bool hasIncludes = false;
+
+    // Compiled automaton
+    std::vector<int> delta;                    // state * 256 + byte -> state
+    std::vector<std::vector<int>> outputs;     // state -> rule ids ending here (incl. suffixes)
+    bool compiled = false;
+
+    static unsigned char lower(unsigned char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + 32) : c;
+    }
+
+    void compile() {
+        std::vector<std::vector<int>> go(1, std::vector<int>(256, -1));
+        outputs.assign(1, {});
+
+        for (size_t id = 0; id < rules.size(); ++id) {
+            int s = 0;
+            for (unsigned char c : rules[id].pattern) {
+                c = lower(c);
+                if (go[s][c] == -1) {
+                    go[s][c] = static_cast<int>(go.size());
+                    go.emplace_back(256, -1);
+                    outputs.emplace_back();
+                }
+                s = go[s][c];
+            }
+            outputs[s].push_back(static_cast<int>(id));
+        }
+
+        // BFS: failure links folded into a complete transition table
+        std::vector<int> fail(go.size(), 0);
+        std::queue<int> q;
+        for (int c = 0; c < 256; ++c) {
+            if (go[0][c] == -1) go[0][c] = 0;
+            else q.push(go[0][c]);
+        }
+        while (!q.empty()) {
+            int s = q.front();
+            q.pop();
+            const auto& inherited = outputs[fail[s]];
+            outputs[s].insert(outputs[s].end(), inherited.begin(), inherited.end());
+            for (int c = 0; c < 256; ++c) {
+                int t = go[s][c];
+                if (t == -1) {
+                    go[s][c] = go[fail[s]][c];
+                } else {
+                    fail[t] = go[fail[s]][c];
+                    q.push(t);
+                }
+            }
+        }
+
+        delta.assign(go.size() * 256, 0);
+        for (size_t s = 0; s < go.size(); ++s) {
+            for (int c = 0; c < 256; ++c) delta[s * 256 + c] = go[s][c];
+        }
+        compiled = true;
+    }
+
+public:
+    // Not allowed once the filter is shared with other threads: it drops the
+    // compiled automaton, and readers would see it half rebuilt
+    void addRule(RuleKind kind, const std::string& pattern) {
+        if (pattern.empty()) return;
+        rules.push_back({pattern, kind});
+        if (kind == INCLUDE_PREFIX) hasIncludes = true;
+        compiled = false;
+    }
+
+    Verdict classify(const std::string& url) {
+        if (!compiled) compile();
+        return static_cast<const UrlFilter&>(*this).classifyCompiled(url);
+    }
+
+    // Thread-safe once compiled (call prepare() before sharing across threads).
+    // Without it nothing is accepted, and the first call says so.
+    Verdict classifyCompiled(const std::string& url) const {
+        if (!compiled) {
+            static std::atomic<bool> warned{false};
+            if (!warned.exchange(true)) {
+                LOG_ERROR("[UrlFilter] classifyCompiled() before prepare(), rejecting every URL");
+            }
+            return NOT_INCLUDED;
+        }
+        bool included = !hasIncludes;
+        bool inPath = true;                      // Still before '?' / '#'
+        int s = 0;
+        const size_t n = url.size();
+
+        for (size_t i = 0; i < n; ++i) {
+            unsigned char c = static_cast<unsigned char>(url[i]);
+            s = delta[s * 256 + lower(c)];
+
+            for (int id : outputs[s]) {
+                const Rule& r = rules[id];
+                bool atStart = i + 1 == r.pattern.size();
+                switch (r.kind) {
+                    case INCLUDE_PREFIX:
+                        if (atStart) included = true;
+                        break;
+                    case EXCLUDE_PREFIX:
+                        if (atStart) return EXCLUDED_PREFIX;
+                        break;
+                    case EXCLUDE_SUBSTRING:
+                        return EXCLUDED_SUBSTRING;
+                    case EXCLUDE_EXTENSION:
+                        if (inPath && (i + 1 == n || url[i + 1] == '?' || url[i + 1] == '#')) {
+                            return EXCLUDED_EXTENSION;
+                        }
+                        break;
+                }
+            }
+            if (c == '?' || c == '#') inPath = false;
+        }
+        return included ? ACCEPTED : NOT_INCLUDED;
+    }
+
+    bool accepts(const std::string& url) const {
+        return classifyCompiled(url) == ACCEPTED;
+    }
+
+    void prepare() {
+        if (!compiled) compile();
+    }
+
+    size_t ruleCount() const { return rules.size(); }
+
+    // Rule file: one "<kind> <pattern>" per line, '#' comments.
+    // Kinds: include-prefix, exclude-prefix, exclude-substring, exclude-extension
+    static bool loadFile(const std::string& path, UrlFilter& out) {
+        std::ifstream in(path);
+        if (!in.good()) return false;
+        UrlFilter filter;
+        std::string line;
+        while (std::getline(in, line)) {
+            std::stringstream ss(line);
+            std::string kind, pattern;
+            if (!(ss >> kind) || kind[0] == '#') continue;
+            if (!(ss >> pattern)) continue;
+            if (kind == "include-prefix") filter.addRule(INCLUDE_PREFIX, pattern);
+            else if (kind == "exclude-prefix") filter.addRule(EXCLUDE_PREFIX, pattern);
+            else if (kind == "exclude-substring") filter.addRule(EXCLUDE_SUBSTRING, pattern);
+            else if (kind == "exclude-extension") filter.addRule(EXCLUDE_EXTENSION, pattern);
+        }
+        filter.prepare();
+        out = std::move(filter);
+        return true;
+    }
+
+    // English Wikipedia articles only, no static assets or meta namespaces
+    static UrlFilter wikipediaDefaults() {
+        UrlFilter f;
+        f.addRule(INCLUDE_PREFIX, "https://en.wikipedia.org/wiki/");
+        for (const char* ext : {".css", ".js", ".png", ".jpg", ".jpeg", ".ico", ".svg", ".gif", ".pdf"}) {
+            f.addRule(EXCLUDE_EXTENSION, ext);
+        }
+        f.addRule(EXCLUDE_SUBSTRING, "/wiki/Wikipedia:");
+        f.addRule(EXCLUDE_SUBSTRING, "/wiki/Help:");
+        f.addRule(EXCLUDE_SUBSTRING, "/wiki/Talk:");
+        f.addRule(EXCLUDE_SUBSTRING, "?");
+        f.prepare();
+        return f;
+    }
+};
+
+#endif
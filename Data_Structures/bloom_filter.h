@@ -0,0 +1,78 @@
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include "fingerprint.h"
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Thread-safe Bloom filter over 64-bit fingerprints. Bits live in atomic words
+// and are only ever set, so readers and writers never lock. Probes use double
+// hashing (h1 + i*h2) on the two halves of the fingerprint.
+class BloomFilter {
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+    uint64_t numBits;
+    int numHashes;
+
+public:
+    // Sized for `expectedItems` at the given false-positive rate
+    BloomFilter(size_t expectedItems, double falsePositiveRate) {
+        double n = static_cast<double>(expectedItems > 0 ? expectedItems : 1);
+        double ln2 = std::log(2.0);
+        double m = -n * std::log(falsePositiveRate) / (ln2 * ln2);
+        numBits = (static_cast<uint64_t>(m) + 63) & ~63ULL;
+        if (numBits < 64) numBits = 64;
+        numHashes = static_cast<int>(std::round(m / n * ln2));
+        if (numHashes < 1) numHashes = 1;
+
+        words.reset(new std::atomic<uint64_t>[numBits / 64]);
+        for (uint64_t i = 0; i < numBits / 64; ++i) {
+            words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    BloomFilter(const BloomFilter&) = delete;
+    BloomFilter& operator=(const BloomFilter&) = delete;
+
+    // Sets the key's bits; true if at least one was unset (key definitely new)
+    bool insert(uint64_t fp) {
+        uint64_t h1 = fp & 0xffffffffULL;
+        uint64_t h2 = (fp >> 32) | 1;
+        bool added = false;
+        for (int i = 0; i < numHashes; ++i) {
+            uint64_t bit = (h1 + i * h2) % numBits;
+            uint64_t mask = 1ULL << (bit & 63);
+            uint64_t prev = words[bit >> 6].fetch_or(mask, std::memory_order_relaxed);
+            if (!(prev & mask)) added = true;
+        }
+        return added;
+    }
+
+    // False means definitely never inserted
+    bool mightContain(uint64_t fp) const {
+        uint64_t h1 = fp & 0xffffffffULL;
+        uint64_t h2 = (fp >> 32) | 1;
+        for (int i = 0; i < numHashes; ++i) {
+            uint64_t bit = (h1 + i * h2) % numBits;
+            if (!(words[bit >> 6].load(std::memory_order_relaxed) & (1ULL << (bit & 63)))) return false;
+        }
+        return true;
+    }
+
+    bool insert(const std::string& key) { return insert(fingerprint64(key)); }
+    bool mightContain(const std::string& key) const { return mightContain(fingerprint64(key)); }
+
+    size_t sizeInBytes() const { return numBits / 8; }
+    int hashCount() const { return numHashes; }
+
+    void clear() {
+        for (uint64_t i = 0; i < numBits / 64; ++i) {
+            words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef CONCURRENT_URL_SET_H
+#define CONCURRENT_URL_SET_H
+
+#include "fingerprint.h"
+#include "bloom_filter.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Lock-striped set of 64-bit URL fingerprints. Keys are 8 bytes instead of a full
+// string, shards are independent open-addressing tables, and an optional Bloom
+// filter in front answers most "never seen" lookups without touching a lock.
+class ConcurrentUrlSet {
+public:
+    struct Config {
+        int shardBits = 6;                 // 2^6 = 64 independently locked shards; clamped to [1, 16]
+        size_t initialCapacityPerShard = 1024;
+        size_t bloomExpectedItems = 0;     // 0 disables the Bloom prefilter
+        double bloomFalsePositiveRate = 0.01;
+    };
+
+private:
+    struct alignas(64) Shard {
+        std::mutex mtx;
+        std::vector<uint64_t> slots;       // 0 = empty slot
+        size_t count = 0;
+    };
+
+    int shardBits;
+    std::unique_ptr<Shard[]> shards;
+    std::unique_ptr<BloomFilter> bloom;
+    std::atomic<size_t> total{0};
+
+    // 0 marks an empty slot, so it is remapped onto a fixed non-zero key
+    static uint64_t normalize(uint64_t fp) { return fp == 0 ? 0x9e3779b97f4a7c15ULL : fp; }
+
+    Shard& shardFor(uint64_t fp) const {
+        return shards[fp >> (64 - shardBits)];  // Top bits pick the shard, low bits the slot
+    }
+
+    static bool probe(const std::vector<uint64_t>& slots, uint64_t fp, size_t& pos) {
+        size_t mask = slots.size() - 1;
+        pos = fp & mask;
+        while (slots[pos] != 0) {
+            if (slots[pos] == fp) return true;
+            pos = (pos + 1) & mask;
+        }
+        return false;
+    }
+
+    static void grow(Shard& s) {
+        std::vector<uint64_t> bigger(s.slots.size() * 2, 0);
+        size_t pos;
+        for (uint64_t fp : s.slots) {
+            if (fp == 0) continue;
+            probe(bigger, fp, pos);
+            bigger[pos] = fp;
+        }
+        s.slots.swap(bigger);
+    }
+
+public:
+    ConcurrentUrlSet() : ConcurrentUrlSet(Config()) {}
+
+    // 0 would make shardFor() shift by 64 (undefined); past 16 the shard array alone is huge
+    explicit ConcurrentUrlSet(const Config& cfg) : shardBits(std::min(std::max(cfg.shardBits, 1), 16)) {
+        size_t capacity = 16;
+        while (capacity < cfg.initialCapacityPerShard) capacity <<= 1;
+        shards.reset(new Shard[size_t(1) << shardBits]);
+        for (size_t i = 0; i < (size_t(1) << shardBits); ++i) {
+            shards[i].slots.assign(capacity, 0);
+        }
+        if (cfg.bloomExpectedItems > 0) {
+            bloom.reset(new BloomFilter(cfg.bloomExpectedItems, cfg.bloomFalsePositiveRate));
+        }
+    }
+
+    ConcurrentUrlSet(const ConcurrentUrlSet&) = delete;
+    ConcurrentUrlSet& operator=(const ConcurrentUrlSet&) = delete;
+
+    // True if the fingerprint was not present before (caller "claims" the URL)
+    bool insert(uint64_t fp) {
+        fp = normalize(fp);
+        Shard& s = shardFor(fp);
+        std::lock_guard<std::mutex> lock(s.mtx);
+        size_t pos;
+        if (probe(s.slots, fp, pos)) return false;
+        s.slots[pos] = fp;
+        s.count++;
+        total.fetch_add(1, std::memory_order_relaxed);
+        if (s.count * 2 > s.slots.size()) grow(s);   // Keep load factor <= 0.5
+        if (bloom) bloom->insert(fp);
+        return true;
+    }
+
+    bool contains(uint64_t fp) const {
+        fp = normalize(fp);
+        if (bloom && !bloom->mightContain(fp)) return false;  // Lock-free negative
+        Shard& s = shardFor(fp);
+        std::lock_guard<std::mutex> lock(s.mtx);
+        size_t pos;
+        return probe(s.slots, fp, pos);
+    }
+
+    bool insert(const std::string& url) { return insert(fingerprint64(url)); }
+    bool contains(const std::string& url) const { return contains(fingerprint64(url)); }
+
+    size_t size() const {
+        return total.load(std::memory_order_relaxed);
+    }
+
+    // Every stored fingerprint (e.g. for checkpointing)
+    std::vector<uint64_t> getAll() const {
+        std::vector<uint64_t> all;
+        all.reserve(size());
+        for (size_t i = 0; i < (size_t(1) << shardBits); ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mtx);
+            for (uint64_t fp : shards[i].slots) {
+                if (fp != 0) all.push_back(fp);
+            }
+        }
+        return all;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < (size_t(1) << shardBits); ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mtx);
+            std::fill(shards[i].slots.begin(), shards[i].slots.end(), 0);
+            shards[i].count = 0;
+        }
+        total = 0;
+        if (bloom) bloom->clear();
+    }
+};
+
+#endif
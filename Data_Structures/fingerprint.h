@@ -0,0 +1,25 @@
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+
+#include <string>
+#include <cstdint>
+
+// 64-bit FNV-1a with a splitmix finalizer: cheap, and well spread in every bit
+// so callers can slice it into shard / bucket / Bloom probe indexes.
+inline uint64_t fingerprint64(const char* data, size_t len) {
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ULL;
+    }
+    h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+inline uint64_t fingerprint64(const std::string& s) {
+    return fingerprint64(s.data(), s.size());
+}
+
+#endif
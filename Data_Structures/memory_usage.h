@@ -0,0 +1,53 @@
+#ifndef MEMORY_USAGE_H
+#define MEMORY_USAGE_H
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+// Bytes held by a structure, split into keys, values and overhead (bucket
+// tables, node links, malloc headers and rounding). An estimate: a full walk of
+// the structure with each allocation modelled as a glibc chunk (see chunk()),
+// so it can land a few percent off the heap an ATMX_COUNT_ALLOCATIONS build
+// measures.
+struct MemoryUsage {
+    size_t keys = 0;
+    size_t values = 0;
+    size_t overhead = 0;
+    size_t entries = 0;                      // Top-level keys or nodes (not those of nested containers)
+
+    size_t total() const { return keys + values + overhead; }
+
+    MemoryUsage& operator+=(const MemoryUsage& other) {
+        keys += other.keys;
+        values += other.values;
+        overhead += other.overhead;
+        entries += other.entries;
+        return *this;
+    }
+
+    // What glibc malloc hands out for a request: 8-byte header, 16-byte
+    // alignment, 32-byte minimum chunk
+    static size_t chunk(size_t requested) {
+        size_t n = (requested + 8 + 15) & ~static_cast<size_t>(15);
+        return n < 32 ? 32 : n;
+    }
+
+    // Heap buffer behind a string; libstdc++ keeps up to 15 chars inline
+    static size_t heap(const std::string& s) {
+        return s.capacity() > 15 ? chunk(s.capacity() + 1) : 0;
+    }
+};
+
+// Adds a value stored inside a node: its inline bytes plus anything it owns.
+// Containers add their own overloads next to their definitions.
+template <typename T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type addMemory(MemoryUsage& usage, const T&) {
+    usage.values += sizeof(T);
+}
+
+inline void addMemory(MemoryUsage& usage, const std::string& s) {
+    usage.values += sizeof(s) + MemoryUsage::heap(s);
+}
+
+#endif
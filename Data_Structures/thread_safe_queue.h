@@ -1,62 +1,214 @@
-#ifndef THREAD_SAFE_QUEUE_H
-#define THREAD_SAFE_QUEUE_H
-
-#include "queue.h"
-#include <mutex>
-#include <condition_variable>
-#include <string>
-
-class ThreadSafeQueue {
-private:
-    Queue q;                                  
-    mutable std::mutex mtx;                    // Mutable for use in const empty()
-    std::condition_variable cv;                // Notifies waiting consumers
-
-public:
-    ThreadSafeQueue() = default;
-
-    // Delete copy constructor and assignment to prevent double-locking/double-free issues
-    ThreadSafeQueue(const ThreadSafeQueue&) = delete;
-    ThreadSafeQueue& operator=(const ThreadSafeQueue&) = delete;
-
-    // Producer: add a URL to the queue
-    void push(const std::string& item) {
-        std::unique_lock<std::mutex> lock(mtx);
-        q.enqueue(item);
-        cv.notify_one();                       // Wake one waiting consumer
-    }
-
-    // Consumer: non-blocking attempt to get an item
-    bool try_pop(std::string& item) {
-        std::unique_lock<std::mutex> lock(mtx);
-        if (q.isEmpty()) {
-            return false;
-        }
-        item = q.dequeue();
-        return true;
-    }
-
-    // Consumer: blocking wait until an item is available
-    void wait_and_pop(std::string& item) {
-        std::unique_lock<std::mutex> lock(mtx);
-        cv.wait(lock, [this] { return !q.isEmpty(); });
-        item = q.dequeue();
-    }
-
-    // Check if queue is empty (thread-safe)
-    bool empty() const {
-        std::unique_lock<std::mutex> lock(mtx);
-        return q.isEmpty();
-    }
-
-    // Clear all items — useful for reset or shutdown
-    void clear() {
-        std::unique_lock<std::mutex> lock(mtx);
-        while (!q.isEmpty()) {
-            q.dequeue();                       // Properly frees nodes
-        }
-        cv.notify_all();                       // Wake any waiting threads
-    }
-};
-
-#endif 
\ No newline at end of file
+#ifndef THREAD_SAFE_QUEUE_H
+#define THREAD_SAFE_QUEUE_H
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Bounded multi-producer / multi-consumer ring buffer (Vyukov style).
+// push/pop are lock-free; the mutex + condition variables are only touched
+// when a thread actually has to sleep on an empty or full queue.
+template <typename T = std::string>
+class ThreadSafeQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::vector<Cell> cells;
+    size_t mask;
+
+    alignas(64) std::atomic<size_t> head{0};   // Next slot to pop
+    alignas(64) std::atomic<size_t> tail{0};   // Next slot to push
+    alignas(64) std::atomic<bool> closed{false};
+
+    std::mutex waitMtx;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::atomic<int> sleepingConsumers{0};
+    std::atomic<int> sleepingProducers{0};
+
+    static size_t roundUpPow2(size_t n) {
+        size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    void wake(std::atomic<int>& sleepers, std::condition_variable& cv) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(waitMtx);
+            cv.notify_one();
+        }
+    }
+
+    template <typename Op>
+    bool sleepUntil(std::atomic<int>& sleepers, std::condition_variable& cv,
+                    std::chrono::steady_clock::time_point deadline, Op attempt) {
+        std::unique_lock<std::mutex> lock(waitMtx);
+        sleepers.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool ok = false;
+        while (!(ok = attempt()) && !closed.load(std::memory_order_acquire)) {
+            if (cv.wait_until(lock, deadline) == std::cv_status::timeout) {
+                ok = attempt();
+                break;
+            }
+        }
+        sleepers.fetch_sub(1);
+        return ok;
+    }
+
+    template <typename U>
+    bool enqueue(U&& item) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::forward<U>(item);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;                      // Full
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool dequeue(T& item) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    item = std::move(cell.value);
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;                      // Empty
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template <typename U>
+    bool tryPushImpl(U&& item) {
+        if (closed.load(std::memory_order_acquire)) return false;
+        if (!enqueue(std::forward<U>(item))) return false;
+        wake(sleepingConsumers, notEmpty);
+        return true;
+    }
+
+    template <typename U>
+    bool pushImpl(U&& item) {
+        if (tryPushImpl(std::forward<U>(item))) return true;
+        while (!closed.load(std::memory_order_acquire)) {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+            bool ok = sleepUntil(sleepingProducers, notFull, deadline,
+                                 [&] { return enqueue(std::forward<U>(item)); });
+            if (ok) {
+                wake(sleepingConsumers, notEmpty);
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    explicit ThreadSafeQueue(size_t capacity = 1 << 16)
+        : cells(roundUpPow2(capacity)), mask(roundUpPow2(capacity) - 1) {
+        for (size_t i = 0; i < cells.size(); ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Delete copy constructor and assignment to prevent double-locking/double-free issues
+    ThreadSafeQueue(const ThreadSafeQueue&) = delete;
+    ThreadSafeQueue& operator=(const ThreadSafeQueue&) = delete;
+
+    // Producer: non-blocking; false if the queue is full or shut down.
+    // A rejected rvalue is left untouched so the caller can retry or reroute it.
+    bool try_push(T&& item) { return tryPushImpl(std::move(item)); }
+    bool try_push(const T& item) { return tryPushImpl(item); }
+
+    // Producer: waits for space (backpressure); false on shutdown
+    bool push(T&& item) { return pushImpl(std::move(item)); }
+    bool push(const T& item) { return pushImpl(item); }
+
+    // Consumer: non-blocking attempt to get an item
+    bool try_pop(T& item) {
+        if (!dequeue(item)) return false;
+        wake(sleepingProducers, notFull);
+        return true;
+    }
+
+    // Consumer: waits up to `timeout`; false on timeout or once shut down and drained
+    template <typename Rep, typename Period>
+    bool pop_for(T& item, std::chrono::duration<Rep, Period> timeout) {
+        if (try_pop(item)) return true;
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        bool ok = sleepUntil(sleepingConsumers, notEmpty, deadline,
+                             [&] { return dequeue(item); });
+        if (ok) wake(sleepingProducers, notFull);
+        return ok;
+    }
+
+    // Consumer: blocks until an item arrives; false once shut down and drained
+    bool wait_and_pop(T& item) {
+        while (true) {
+            if (pop_for(item, std::chrono::seconds(1))) return true;
+            if (closed.load(std::memory_order_acquire)) return try_pop(item);
+        }
+    }
+
+    // Rejects further pushes and wakes every sleeping thread; queued items stay poppable
+    void shutdown() {
+        closed.store(true, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(waitMtx);
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    bool isShutdown() const {
+        return closed.load(std::memory_order_acquire);
+    }
+
+    // Approximate under concurrent use
+    size_t size() const {
+        size_t t = tail.load(std::memory_order_acquire);
+        size_t h = head.load(std::memory_order_acquire);
+        return t > h ? t - h : 0;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    size_t capacity() const {
+        return cells.size();
+    }
+
+    // Drop all items — useful for reset or shutdown
+    void clear() {
+        T discard;
+        while (try_pop(discard)) {}
+    }
+};
+
+#endif
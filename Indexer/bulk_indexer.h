@@ -0,0 +1,210 @@
+#ifndef BULK_INDEXER_H
+#define BULK_INDEXER_H
+
+#include "../Crawler/link_parser.h"
+#include "../Crawler/url_canonicalizer.h"
+#include "../Crawler/url_filter.h"
+#include "../Data_Structures/concurrent_url_set.h"
+#include "../Data_Structures/graph.h"
+#include "../Data_Structures/thread_safe_queue.h"
+#include "../Data_Structures/trie.h"
+#include "../Indexer/inverted_index.h"
+#include "../Scraper/scraper.h"
+#include "../Storage/local_source.h"
+#include "../Storage/page_store.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sys/stat.h>
+
+// Builds the inverted index, trie and link graph from pages already on disk
+// (the crawler's page store, a directory or tar of saved HTML, ...), using every
+// core and no network. One thread pulls pages from the source; the workers do
+// text extraction, tokenizing and link extraction in parallel and only take a
+// lock to merge each finished page into the shared structures.
+class BulkIndexer {
+public:
+    using Source = std::function<bool(StoredPage&)>;   // Returns false when exhausted
+
+    struct Config {
+        int threads = 0;                    // 0 = std::thread::hardware_concurrency()
+        size_t queueCapacity = 256;
+        const UrlFilter* linkFilter = nullptr;   // Graph edges only to accepted links (null = all)
+    };
+
+    struct Stats {
+        uint64_t pages = 0;
+        uint64_t duplicates = 0;            // Same URL seen again; the latest copy wins when known, else the first
+        uint64_t bytes = 0;                 // HTML bytes processed
+        double seconds = 0.0;
+
+        double pagesPerSec() const { return seconds > 0 ? pages / seconds : 0.0; }
+        double mbPerSec() const { return seconds > 0 ? bytes / 1e6 / seconds : 0.0; }
+    };
+
+    // URL fingerprint -> ordinal of the record to index (see latestRecords)
+    using LatestRecords = std::unordered_map<uint64_t, uint64_t>;
+
+    // Ordinal of the last usable record of every URL in `source`. Page stores are
+    // append-only, so a page fetched again later appears twice and its last
+    // record is the current one.
+    static LatestRecords latestRecords(const Source& source) {
+        LatestRecords latest;
+        StoredPage page;
+        for (uint64_t ordinal = 0; source(page); ++ordinal) {
+            CanonicalUrl url = UrlCanonicalizer::canonicalize(page.url);
+            if (url.valid && !page.body.empty()) latest[url.fingerprint] = ordinal;
+            page = StoredPage();
+        }
+        return latest;
+    }
+
+    // With `latest`, only each URL's winning record is indexed; without it the
+    // first record of a URL wins
+    static Stats run(const Source& source, InvertedIndex& index, Trie& trie, Graph& graph,
+                     const Config& config, const LatestRecords* latest = nullptr) {
+        int threads = config.threads > 0 ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+        if (threads <= 0) threads = 4;
+
+        struct Record {
+            uint64_t ordinal = 0;           // Position in the source
+            StoredPage page;
+        };
+        ThreadSafeQueue<Record> queue(config.queueCapacity);
+        ConcurrentUrlSet seen;
+        std::mutex indexMutex, graphMutex;
+        std::atomic<uint64_t> pages{0}, duplicates{0}, bytes{0};
+        auto start = std::chrono::steady_clock::now();
+
+        auto worker = [&]() {
+            Record record;
+            while (queue.wait_and_pop(record)) {
+                const StoredPage& page = record.page;
+                CanonicalUrl url = UrlCanonicalizer::canonicalize(page.url);
+                if (!url.valid || page.body.empty()) continue;
+                bool stale;
+                if (latest) {
+                    auto winner = latest->find(url.fingerprint);
+                    stale = winner == latest->end() || winner->second != record.ordinal;
+                } else {
+                    stale = !seen.insert(url.fingerprint);
+                }
+                if (stale) {
+                    duplicates++;
+                    continue;
+                }
+
+                std::vector<std::string> words = Scraper::tokenize(Scraper::extractText(page.body));
+                std::unordered_map<std::string, int> termFreq;
+                for (const auto& w : words) termFreq[w]++;
+
+                std::vector<std::string> targets;
+                for (auto& link : extractCanonicalLinks(page.body, url.url)) {
+                    if (config.linkFilter && !config.linkFilter->accepts(link.url)) continue;
+                    targets.push_back(std::move(link.url));
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(graphMutex);
+                    for (const auto& target : targets) graph.addEdge(url.url, target);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(indexMutex);
+                    for (const auto& tf : termFreq) {
+                        index.add(tf.first, url.url, tf.second);
+                        trie.insert(tf.first);
+                    }
+                }
+                pages++;
+                bytes += page.body.size();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads; ++i) workers.emplace_back(worker);
+
+        Record record;
+        while (source(record.page)) {
+            queue.push(std::move(record));
+            record.ordinal++;
+            record.page = StoredPage();
+        }
+        queue.shutdown();
+        for (auto& t : workers) t.join();
+
+        Stats stats;
+        stats.pages = pages;
+        stats.duplicates = duplicates;
+        stats.bytes = bytes;
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    // Offline reindex of a crawler page store (.warc.gz). A first pass finds the
+    // latest record of every URL, so re-fetched pages are indexed from their
+    // newest HTML.
+    static Stats reindexStore(const std::string& path, InvertedIndex& index, Trie& trie, Graph& graph,
+                              const Config& config) {
+        LatestRecords latest;
+        {
+            PageStoreReader scan(path);
+            if (!scan.isOpen()) {
+                std::cerr << "[Reindex] Cannot open page store " << path << "\n";
+                return Stats();
+            }
+            latest = latestRecords([&scan](StoredPage& p) { return scan.next(p); });
+        }
+        PageStoreReader reader(path);
+        if (!reader.isOpen()) {
+            std::cerr << "[Reindex] Cannot open page store " << path << "\n";
+            return Stats();
+        }
+        return run([&reader](StoredPage& p) { return reader.next(p); }, index, trie, graph, config, &latest);
+    }
+
+    // Ingests saved HTML from a directory tree, a .tar / .tar.gz / .tgz archive or
+    // a WARC file; `mapper` supplies the URL of every file (WARC records carry their own)
+    static Stats ingest(const std::string& path, const LocalUrlMapper& mapper, InvertedIndex& index,
+                        Trie& trie, Graph& graph, const Config& config) {
+        auto endsWith = [&path](const std::string& suffix) {
+            return path.size() >= suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+        };
+
+        struct stat st;
+        if (::stat(path.c_str(), &st) != 0) {
+            std::cerr << "[Ingest] Cannot read " << path << "\n";
+            return Stats();
+        }
+        if (S_ISDIR(st.st_mode)) {
+            DirectorySource dir(path, mapper);
+            std::cout << "[Ingest] " << dir.fileCount() << " files under " << path << "\n";
+            Stats stats = run([&dir](StoredPage& p) { return dir.next(p); }, index, trie, graph, config);
+            if (dir.skippedFiles() > 0) std::cout << "[Ingest] Skipped " << dir.skippedFiles() << " files without a URL\n";
+            return stats;
+        }
+        if (endsWith(".warc") || endsWith(".warc.gz")) {
+            return reindexStore(path, index, trie, graph, config);
+        }
+        if (endsWith(".tar") || endsWith(".tar.gz") || endsWith(".tgz")) {
+            TarSource tar(path, mapper);
+            if (!tar.isOpen()) {
+                std::cerr << "[Ingest] Cannot open archive " << path << "\n";
+                return Stats();
+            }
+            Stats stats = run([&tar](StoredPage& p) { return tar.next(p); }, index, trie, graph, config);
+            if (tar.skippedFiles() > 0) std::cout << "[Ingest] Skipped " << tar.skippedFiles() << " entries without a URL\n";
+            return stats;
+        }
+        std::cerr << "[Ingest] Unsupported input " << path << " (expected a directory, .tar[.gz] or .warc[.gz])\n";
+        return Stats();
+    }
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef DOCUMENT_TABLE_H
+#define DOCUMENT_TABLE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Canonical URL -> docID, plus the aliases (redirect sources, pages whose
+// <link rel="canonical"> points elsewhere) that resolve to it. Keys are the
+// canonical URL fingerprints, so the same page reached under another spelling
+// maps onto one document instead of being fetched and indexed again.
+class DocumentTable {
+private:
+    mutable std::mutex mtx;
+    std::unordered_map<uint64_t, int> docIds;          // Canonical fingerprint -> docID
+    std::unordered_map<uint64_t, uint64_t> aliases;    // Alias fingerprint -> canonical fingerprint
+    std::vector<std::string> urls;                     // docID -> canonical URL
+    std::unordered_map<uint64_t, std::string> aliasTargets;  // Canonical fingerprint -> URL
+
+    uint64_t follow(uint64_t fp) const {
+        auto it = aliases.find(fp);
+        return it == aliases.end() ? fp : it->second;
+    }
+
+public:
+    // Registers a canonical document; returns its docID (existing one if already known)
+    int addDocument(uint64_t fp, const std::string& url) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = docIds.find(fp);
+        if (it != docIds.end()) return it->second;
+        int id = static_cast<int>(urls.size());
+        urls.push_back(url);
+        docIds.emplace(fp, id);
+        return id;
+    }
+
+    // Records that `aliasFp` is another name for the canonical page `canonicalFp`
+    void addAlias(uint64_t aliasFp, uint64_t canonicalFp, const std::string& canonicalUrl) {
+        if (aliasFp == canonicalFp) return;
+        std::lock_guard<std::mutex> lock(mtx);
+        aliases[aliasFp] = canonicalFp;
+        aliasTargets.emplace(canonicalFp, canonicalUrl);
+    }
+
+    // docID for a canonical or alias fingerprint, -1 if unknown
+    int lookup(uint64_t fp) const {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = docIds.find(follow(fp));
+        return it == docIds.end() ? -1 : it->second;
+    }
+
+    bool isAlias(uint64_t fp) const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return aliases.count(fp) > 0;
+    }
+
+    // Canonical URL for `url` if it is a known alias, otherwise `url` itself
+    std::string resolve(uint64_t fp, const std::string& url) const {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto alias = aliases.find(fp);
+        if (alias == aliases.end()) return url;
+        auto target = aliasTargets.find(alias->second);
+        return target == aliasTargets.end() ? url : target->second;
+    }
+
+    std::string getUrl(int docId) const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return (docId >= 0 && docId < static_cast<int>(urls.size())) ? urls[docId] : "";
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return urls.size();
+    }
+
+    size_t aliasCount() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return aliases.size();
+    }
+};
+
+#endif
@@ -1,54 +1,100 @@
-#ifndef INVERTED_INDEX_H
-#define INVERTED_INDEX_H
-
-#include "Data_Structures/hashmap.h"
-#include <string>
-#include <vector>
-
-class InvertedIndex {
-private:
-    HashMap<HashMap<int>> index;
-    HashMap<int> docLengths;
-
-public:
-    void add(const std::string& word, const std::string& url) {
-        index[word][url]++;
-        docLengths[url]++;
-    }
-
-    // Changed: returns by value (HashMap<int>)
-    HashMap<int> getPostings(const std::string& word) const {
-        if (index.contains(word)) {
-            return index.get(word); 
-        }
-        return HashMap<int>(); 
-    }
-
-    int getDocLength(const std::string& url) const {
-        return docLengths.contains(url) ? docLengths.get(url) : 0;
-    }
-
-    size_t getDocCount() const {
-        return docLengths.size();
-    }
-
-    size_t getDocumentFrequency(const std::string& word) const {
-        // This is safe because it calls size() on a temporary copy
-        return getPostings(word).size();
-    }
-
-    std::vector<std::string> getAllWords() const {
-        return index.getKeys();
-    }
-
-    std::vector<std::string> getAllDocuments() const {
-        return docLengths.getKeys();
-    }
-
-    void clear() {
-        index.clear();
-        docLengths.clear();
-    }
-};
-
+#ifndef INVERTED_INDEX_H
+#define INVERTED_INDEX_H
+
+#include "Data_Structures/hashmap.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+class InvertedIndex {
+private:
+    HashMap<HashMap<int>> index;
+    HashMap<int> docLengths;
+
+public:
+    void add(const std::string& word, const std::string& url) {
+        index[word][url]++;
+        docLengths[url]++;
+    }
+
+    // `count` occurrences at once (reloading saved term frequencies)
+    void add(const std::string& word, const std::string& url, int count) {
+        index[word][url] += count;
+        docLengths[url] += count;
+    }
+
+    // Changed: returns by value (HashMap<int>)
+    HashMap<int> getPostings(const std::string& word) const {
+        if (index.contains(word)) {
+            return index.get(word); 
+        }
+        return HashMap<int>(); 
+    }
+
+    int getDocLength(const std::string& url) const {
+        return docLengths.contains(url) ? docLengths.get(url) : 0;
+    }
+
+    size_t getDocCount() const {
+        return docLengths.size();
+    }
+
+    size_t getTermCount() const {
+        return index.size();
+    }
+
+    // Term postings (one 10007-bucket HashMap per term) and document lengths
+    MemoryUsage postingsMemory() const { return index.memoryUsage(); }
+    MemoryUsage docLengthMemory() const { return docLengths.memoryUsage(); }
+
+    MemoryUsage memoryUsage() const {
+        MemoryUsage usage = postingsMemory();
+        usage += docLengthMemory();
+        return usage;
+    }
+
+    // (term, document) pairs across the whole index
+    size_t getPostingCount() const {
+        size_t total = 0;
+        index.forEach([&total](const std::string&, const HashMap<int>& postings) { total += postings.size(); });
+        return total;
+    }
+
+    size_t getDocumentFrequency(const std::string& word) const {
+        // This is safe because it calls size() on a temporary copy
+        return getPostings(word).size();
+    }
+
+    // One "word|url;url;..." line per term (the format main() loads at startup)
+    bool save(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out.good()) return false;
+        for (const auto& word : getAllWords()) {
+            const auto& postings = index.get(word);
+            if (postings.size() == 0) continue;
+            out << word << "|";
+            auto urls = postings.getKeys();
+            for (size_t i = 0; i < urls.size(); ++i) {
+                out << urls[i];
+                if (i + 1 < urls.size()) out << ";";
+            }
+            out << "\n";
+        }
+        return out.good();
+    }
+
+    std::vector<std::string> getAllWords() const {
+        return index.getKeys();
+    }
+
+    std::vector<std::string> getAllDocuments() const {
+        return docLengths.getKeys();
+    }
+
+    void clear() {
+        index.clear();
+        docLengths.clear();
+    }
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,126 @@
+#ifndef NEAR_DUPLICATE_H
+#define NEAR_DUPLICATE_H
+
+#include "../Data_Structures/fingerprint.h"
+#include "../Logger/logger.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 64-bit SimHash over word shingles, looked up through a banded LSH index.
+// Two pages within `maxDistance` differing bits are near-duplicates. With
+// 4 bands of 16 bits and maxDistance <= 3, pigeonhole guarantees that every
+// such pair shares at least one band exactly, so only those buckets are scanned.
+class NearDuplicateIndex {
+public:
+    struct Config {
+        int maxDistance = 3;        // Hamming distance (out of 64) still counted as a duplicate; at most BANDS - 1
+        int shingleSize = 3;        // Words per shingle
+        size_t minTokens = 32;      // Shorter pages are too small to fingerprint reliably
+    };
+
+    struct Match {
+        uint64_t fingerprint = 0;   // URL fingerprint of the earlier copy
+        std::string url;
+        int distance = 0;
+    };
+
+private:
+    static constexpr int BANDS = 4;
+    static constexpr int BAND_BITS = 16;
+
+    struct Entry {
+        uint64_t signature;
+        uint64_t fingerprint;
+        std::string url;
+    };
+
+    Config config;
+    std::mutex mtx;
+    std::vector<Entry> entries;
+    std::unordered_map<uint32_t, std::vector<int>> bands[BANDS];   // Band value -> entry ids
+
+    static uint64_t mix(uint64_t h) {
+        h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+    static uint32_t band(uint64_t signature, int b) {
+        return static_cast<uint32_t>((signature >> (b * BAND_BITS)) & 0xFFFF);
+    }
+
+public:
+    NearDuplicateIndex() : NearDuplicateIndex(Config()) {}
+    // Larger distances would silently miss pairs that share no band, so they are clamped
+    explicit NearDuplicateIndex(const Config& cfg) : config(cfg) {
+        if (config.maxDistance > BANDS - 1) {
+            LOG_WARN("[NearDuplicate] maxDistance " << config.maxDistance << " exceeds what " << BANDS
+                     << " bands can find, using " << BANDS - 1);
+            config.maxDistance = BANDS - 1;
+        }
+        if (config.maxDistance < 0) config.maxDistance = 0;
+    }
+
+    // SimHash of the page's token stream (0 if it has fewer than minTokens)
+    uint64_t signature(const std::vector<std::string>& words) const {
+        if (words.size() < config.minTokens) return 0;
+
+        std::vector<uint64_t> wordHashes;
+        wordHashes.reserve(words.size());
+        for (const auto& w : words) wordHashes.push_back(fingerprint64(w));
+
+        int counts[64] = {0};
+        size_t k = static_cast<size_t>(config.shingleSize);
+        for (size_t i = 0; i + k <= wordHashes.size(); ++i) {
+            uint64_t h = 0;
+            for (size_t j = 0; j < k; ++j) h = mix(h ^ wordHashes[i + j]);
+            for (int bit = 0; bit < 64; ++bit) {
+                counts[bit] += ((h >> bit) & 1) ? 1 : -1;
+            }
+        }
+
+        uint64_t sig = 0;
+        for (int bit = 0; bit < 64; ++bit) {
+            if (counts[bit] > 0) sig |= (uint64_t(1) << bit);
+        }
+        return sig;
+    }
+
+    // Returns true (and fills `match`) if a near-duplicate is already indexed;
+    // otherwise records this page and returns false. Signature 0 is never matched.
+    bool findOrInsert(uint64_t sig, uint64_t fingerprint, const std::string& url, Match& match) {
+        if (sig == 0) return false;
+        std::lock_guard<std::mutex> lock(mtx);
+
+        for (int b = 0; b < BANDS; ++b) {
+            auto it = bands[b].find(band(sig, b));
+            if (it == bands[b].end()) continue;
+            for (int id : it->second) {
+                const Entry& e = entries[id];
+                int distance = __builtin_popcountll(e.signature ^ sig);
+                if (distance <= config.maxDistance) {
+                    match.fingerprint = e.fingerprint;
+                    match.url = e.url;
+                    match.distance = distance;
+                    return true;
+                }
+            }
+        }
+
+        int id = static_cast<int>(entries.size());
+        entries.push_back(Entry{sig, fingerprint, url});
+        for (int b = 0; b < BANDS; ++b) bands[b][band(sig, b)].push_back(id);
+        return false;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return entries.size();
+    }
+};
+
+#endif
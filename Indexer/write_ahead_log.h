@@ -0,0 +1,302 @@
+#ifndef WRITE_AHEAD_LOG_H
+#define WRITE_AHEAD_LOG_H
+
+#include "../Logger/logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Append-only log of index updates, written by one background thread with group
+// commit: appenders only copy their record into a buffer, and the writer turns
+// everything that piled up into one write() + fdatasync(). Indexing never waits
+// for the disk unless it asks to (waitDurable).
+//
+// The log is split into generations (<dir>/wal-000001.log, ...). A checkpoint
+// calls rotate() at the moment it takes its snapshot, and removeBefore() once the
+// snapshot is safely on disk, which drops the generations it now covers.
+//
+// Each record is framed as "begin <lsn>\n<data>commit <lsn>\n"; replay() skips
+// a torn record at the tail of a file.
+class WriteAheadLog {
+public:
+    struct Config {
+        size_t groupCommitBytes = 256 * 1024;               // Flush early once this much is buffered
+        std::chrono::milliseconds groupCommitInterval{50};  // Otherwise flush this often
+        bool fsync = true;                                  // false: survives a crash of the process, not of the machine
+    };
+
+private:
+    struct Batch {
+        uint64_t generation;
+        std::string data;
+    };
+
+    std::string dir;
+    Config config;
+
+    std::mutex mtx;
+    std::condition_variable wake;
+    std::condition_variable durable;
+    std::string pending;
+    std::vector<Batch> sealed;                 // Buffered data of generations already rotated away
+    uint64_t generation = 1;
+    uint64_t appendedLsn = 0;
+    uint64_t durableLsn = 0;
+    bool writeFailed = false;                  // Sticky: nothing after a lost batch is durable
+    bool running = false;
+    bool stopping = false;
+    std::thread writer;
+
+    int fd = -1;                               // Writer thread only
+    uint64_t fdGeneration = 0;
+
+    uint64_t commits = 0;
+    uint64_t bytesWritten = 0;
+
+    static std::string path(const std::string& dir, uint64_t gen) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "/wal-%06llu.log", static_cast<unsigned long long>(gen));
+        return dir + name;
+    }
+
+    void closeFile() {
+        if (fd < 0) return;
+        if (config.fsync) ::fdatasync(fd);
+        ::close(fd);
+        fd = -1;
+    }
+
+    // Returns the bytes written
+    size_t writeBatch(const Batch& b) {
+        if (b.data.empty()) return 0;
+        if (fd < 0 || fdGeneration != b.generation) {
+            closeFile();
+            fd = ::open(path(dir, b.generation).c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+            fdGeneration = b.generation;
+            if (fd < 0) {
+                LOG_ERROR("[WAL] open " << path(dir, b.generation) << ": " << std::strerror(errno));
+                return 0;
+            }
+        }
+        const char* p = b.data.data();
+        size_t left = b.data.size();
+        while (left > 0) {
+            ssize_t n = ::write(fd, p, left);
+            if (n < 0) {
+                LOG_ERROR("[WAL] write " << path(dir, b.generation) << ": " << std::strerror(errno));
+                return b.data.size() - left;
+            }
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+        return b.data.size();
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true) {
+            wake.wait_for(lock, config.groupCommitInterval, [this] {
+                return stopping || !sealed.empty() || pending.size() >= config.groupCommitBytes;
+            });
+            if (pending.empty() && sealed.empty()) {
+                if (stopping) break;
+                continue;
+            }
+
+            std::vector<Batch> batches;
+            batches.swap(sealed);
+            batches.push_back(Batch{generation, std::string()});
+            batches.back().data.swap(pending);
+            uint64_t upTo = appendedLsn;
+            lock.unlock();
+
+            size_t written = 0, expected = 0;
+            for (const auto& b : batches) {
+                written += writeBatch(b);
+                expected += b.data.size();
+            }
+            bool synced = true;
+            if (config.fsync && fd >= 0 && ::fdatasync(fd) != 0) {   // One sync for the whole group
+                LOG_ERROR("[WAL] fdatasync: " << std::strerror(errno));
+                synced = false;
+            }
+
+            lock.lock();
+            bytesWritten += written;
+            if (written != expected || !synced) {
+                if (!writeFailed) {
+                    LOG_ERROR("[WAL] Group commit failed (" << written << " of " << expected
+                              << " bytes), records after LSN " << durableLsn << " are not durable");
+                }
+                writeFailed = true;
+            }
+            if (!writeFailed) durableLsn = upTo;
+            commits++;
+            durable.notify_all();
+        }
+        closeFile();
+    }
+
+public:
+    WriteAheadLog(const std::string& directory, const Config& cfg) : dir(directory), config(cfg) {}
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    ~WriteAheadLog() { stop(); }
+
+    // Generations present on disk, oldest first
+    static std::vector<uint64_t> generations(const std::string& dir) {
+        std::vector<uint64_t> gens;
+        DIR* d = ::opendir(dir.c_str());
+        if (!d) return gens;
+        while (dirent* e = ::readdir(d)) {
+            unsigned long long gen = 0;
+            char tail[8] = {0};
+            if (std::sscanf(e->d_name, "wal-%llu.%4s", &gen, tail) == 2 && std::string(tail) == "log") {
+                gens.push_back(gen);
+            }
+        }
+        ::closedir(d);
+        std::sort(gens.begin(), gens.end());
+        return gens;
+    }
+
+    // Feeds every committed record, oldest first, to `apply`; returns how many
+    static size_t replay(const std::string& dir, const std::function<void(const std::string&)>& apply) {
+        size_t records = 0;
+        for (uint64_t gen : generations(dir)) {
+            std::ifstream in(path(dir, gen));
+            std::string line, record;
+            bool inRecord = false;
+            while (std::getline(in, line)) {
+                if (line.compare(0, 6, "begin ") == 0) {
+                    record.clear();
+                    inRecord = true;
+                } else if (line.compare(0, 7, "commit ") == 0) {
+                    if (inRecord) {
+                        apply(record);
+                        records++;
+                    }
+                    inRecord = false;
+                } else if (inRecord) {
+                    record += line;
+                    record += '\n';
+                }
+            }
+        }
+        return records;
+    }
+
+    // Deletes every generation on disk (a fresh crawl must not replay an old one)
+    void reset() {
+        for (uint64_t gen : generations(dir)) std::remove(path(dir, gen).c_str());
+    }
+
+    // Starts the writer; new records go to `firstGeneration` (past anything replayed)
+    void start(uint64_t firstGeneration) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (running) return;
+        ::mkdir(dir.c_str(), 0755);
+        generation = firstGeneration;
+        running = true;
+        stopping = false;
+        writer = std::thread(&WriteAheadLog::run, this);
+    }
+
+    // Flushes whatever is buffered and stops the writer
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!running) return;
+            stopping = true;
+        }
+        wake.notify_one();
+        if (writer.joinable()) writer.join();
+        std::lock_guard<std::mutex> lock(mtx);
+        running = false;
+    }
+
+    // Buffers one record; returns its log sequence number
+    uint64_t append(const std::string& data) {
+        std::lock_guard<std::mutex> lock(mtx);
+        uint64_t lsn = ++appendedLsn;
+        std::string seq = std::to_string(lsn);
+        pending += "begin " + seq + "\n";
+        pending += data;
+        if (!data.empty() && data.back() != '\n') pending += '\n';
+        pending += "commit " + seq + "\n";
+        if (pending.size() >= config.groupCommitBytes) wake.notify_one();
+        return lsn;
+    }
+
+    // Blocks until record `lsn` (and everything before it) is on disk; false if
+    // a write failed first or the writer is not running
+    bool waitDurable(uint64_t lsn) {
+        std::unique_lock<std::mutex> lock(mtx);
+        wake.notify_one();
+        durable.wait(lock, [&] { return durableLsn >= lsn || writeFailed || !running; });
+        return durableLsn >= lsn;
+    }
+
+    bool flush() {
+        uint64_t lsn;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            lsn = appendedLsn;
+        }
+        return waitDurable(lsn);
+    }
+
+    bool failed() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return writeFailed;
+    }
+
+    // Seals the current generation; later appends go to the returned new one
+    uint64_t rotate() {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!pending.empty()) {
+            sealed.push_back(Batch{generation, std::string()});
+            sealed.back().data.swap(pending);
+        }
+        return ++generation;
+    }
+
+    // Drops generations older than `gen` once their contents are checkpointed;
+    // keeps them (returns false) when the flush before it failed
+    bool removeBefore(uint64_t gen) {
+        if (!flush()) return false;            // Sealed data must not be rewritten after the unlink
+        for (uint64_t g : generations(dir)) {
+            if (g < gen) std::remove(path(dir, g).c_str());
+        }
+        return true;
+    }
+
+    uint64_t commitCount() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return commits;
+    }
+
+    uint64_t bytesLogged() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return bytesWritten;
+    }
+};
+
+#endif
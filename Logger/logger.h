@@ -0,0 +1,351 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Asynchronous logging for the crawl and query hot paths:
+//
+//   LOG_INFO("[SUCCESS] Indexed: " << url);
+//
+// Each thread appends to its own single-producer ring; a background thread
+// drains all rings every few milliseconds and does the actual console I/O, so
+// a worker never blocks on std::cout or a shared mutex. A full ring drops the
+// message (counted) instead of stalling the caller.
+//
+// Levels below ATMX_LOG_LEVEL (0 debug, 1 info, 2 warn, 3 error) are compiled
+// out entirely; the runtime level (setLevel, or ATMX_LOG=debug|info|warn|error)
+// filters the rest. A message repeated word for word at one call site is let
+// through `rateLimit` times a second; the excess is summarised once the second
+// is over. Distinct messages (an error per URL) are never folded together.
+#ifndef ATMX_LOG_LEVEL
+#define ATMX_LOG_LEVEL 0
+#endif
+
+enum class LogLevel : int { Debug = 0, Info = 1, Warn = 2, Error = 3, Off = 4 };
+
+class Logger;
+
+// Per-call-site rate limit state (one static instance per LOG_* statement)
+class LogSite {
+private:
+    static constexpr int SLOTS = 64;
+    static constexpr uint64_t MAX_COUNT = 0xFFFF;
+
+    const char* file;
+    int line;
+    // Per text-hash slot: second (16 bits) << 48 | text hash (32 bits) << 16 |
+    // count (16 bits), updated with one CAS so a new window cannot lose a racing
+    // increment. A slot belongs to the first text that uses it in a second; other
+    // texts hashing there that second pass uncounted.
+    std::atomic<uint64_t> slots[SLOTS] = {};
+    std::atomic<uint64_t> suppressed{0};
+    std::atomic<int64_t> lastSuppressed{0};          // Second of the latest suppression
+
+public:
+    LogSite(const char* f, int l);
+
+    static int64_t nowSeconds() {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // False once `text` has been let through `limit` times this second
+    bool allow(uint32_t limit, const std::string& text) {
+        if (limit >= MAX_COUNT) return true;
+        uint64_t hash = std::hash<std::string>()(text);
+        std::atomic<uint64_t>& slot = slots[hash % SLOTS];
+        int64_t seconds = nowSeconds();
+        uint64_t key = (static_cast<uint64_t>(seconds) & 0xFFFF) << 48 | (hash >> 32) << 16;
+        uint64_t current = slot.load(std::memory_order_relaxed);
+        while (true) {
+            uint64_t next;
+            if ((current >> 48) != (key >> 48)) {
+                next = key | 1;                              // First message of a new second
+            } else if ((current & ~MAX_COUNT) != key) {
+                return true;                                 // Slot held by another text
+            } else if ((current & MAX_COUNT) < limit) {
+                next = current + 1;
+            } else {
+                suppressed.fetch_add(1, std::memory_order_relaxed);
+                lastSuppressed.store(seconds, std::memory_order_relaxed);
+                return false;
+            }
+            if (slot.compare_exchange_weak(current, next, std::memory_order_relaxed)) return true;
+        }
+    }
+
+    // Messages held back in seconds that have ended; resets the count
+    uint64_t takeSuppressed() {
+        if (lastSuppressed.load(std::memory_order_relaxed) == nowSeconds()) return 0;
+        return suppressed.exchange(0, std::memory_order_relaxed);
+    }
+
+    std::string where() const {
+        std::string f = file;
+        size_t slash = f.find_last_of('/');
+        return (slash == std::string::npos ? f : f.substr(slash + 1)) + ":" + std::to_string(line);
+    }
+};
+
+class Logger {
+public:
+    struct Record {
+        uint64_t nanos = 0;
+        LogLevel level = LogLevel::Info;
+        std::string text;
+    };
+
+private:
+    // Single producer (the owning thread), single consumer (the drain thread)
+    class Ring {
+    private:
+        std::vector<Record> slots;
+        size_t mask;
+        alignas(64) std::atomic<size_t> head{0};
+        alignas(64) std::atomic<size_t> tail{0};
+
+    public:
+        explicit Ring(size_t capacityPow2) : slots(capacityPow2), mask(capacityPow2 - 1) {}
+
+        bool push(Record&& r) {
+            size_t t = tail.load(std::memory_order_relaxed);
+            if (t - head.load(std::memory_order_acquire) >= slots.size()) return false;
+            slots[t & mask] = std::move(r);
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop(Record& r) {
+            size_t h = head.load(std::memory_order_relaxed);
+            if (h == tail.load(std::memory_order_acquire)) return false;
+            r = std::move(slots[h & mask]);
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+    };
+
+    static constexpr size_t RING_CAPACITY = 4096;
+
+    std::mutex registryMtx;                          // rings + sites, touched once per thread / site
+    std::vector<std::shared_ptr<Ring>> rings;
+    std::vector<LogSite*> sites;
+
+    std::atomic<int> level{static_cast<int>(LogLevel::Info)};
+    std::atomic<uint32_t> limit{100};
+    std::atomic<uint64_t> dropped{0};
+
+    std::thread drainer;
+    std::atomic<bool> running{true};
+    std::mutex wakeMtx;
+    std::condition_variable wake, drained;
+    uint64_t flushRequested = 0, flushCompleted = 0;    // Guarded by wakeMtx
+
+    static uint64_t nowNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // One pass: everything queued so far, oldest first, then suppression notes
+    void drainOnce() {
+        std::vector<std::shared_ptr<Ring>> snapshot;
+        std::vector<LogSite*> siteSnapshot;
+        {
+            std::lock_guard<std::mutex> lock(registryMtx);
+            snapshot = rings;
+            siteSnapshot = sites;
+        }
+        std::vector<Record> batch;
+        Record r;
+        for (const auto& ring : snapshot) {
+            while (ring->pop(r)) batch.push_back(std::move(r));
+        }
+        std::stable_sort(batch.begin(), batch.end(),
+                         [](const Record& a, const Record& b) { return a.nanos < b.nanos; });
+
+        bool wroteOut = false, wroteErr = false;
+        for (const auto& rec : batch) {
+            // One write per line, so lines printed directly elsewhere never split it
+            if (rec.level >= LogLevel::Warn) {
+                std::cerr << rec.text + "\n";
+                wroteErr = true;
+            } else {
+                std::cout << rec.text + "\n";
+                wroteOut = true;
+            }
+        }
+        for (LogSite* site : siteSnapshot) {
+            uint64_t n = site->takeSuppressed();
+            if (n == 0) continue;
+            std::cerr << "[Logger] " << n << " repeated messages from " << site->where() << " suppressed (rate limit)\n";
+            wroteErr = true;
+        }
+        uint64_t lost = dropped.exchange(0, std::memory_order_relaxed);
+        if (lost > 0) {
+            std::cerr << "[Logger] " << lost << " messages dropped (ring full)\n";
+            wroteErr = true;
+        }
+        if (wroteOut) std::cout.flush();
+        if (wroteErr) std::cerr.flush();
+
+        // Rings of threads that have exited are released once empty
+        snapshot.clear();
+        std::lock_guard<std::mutex> lock(registryMtx);
+        rings.erase(std::remove_if(rings.begin(), rings.end(),
+                                   [](const std::shared_ptr<Ring>& ring) { return ring.use_count() == 1 && ring->empty(); }),
+                    rings.end());
+    }
+
+    void drainLoop() {
+        std::unique_lock<std::mutex> lock(wakeMtx);
+        while (true) {
+            wake.wait_for(lock, std::chrono::milliseconds(20),
+                          [this]() { return !running || flushRequested != flushCompleted; });
+            uint64_t target = flushRequested;
+            bool stopping = !running;
+            lock.unlock();
+            drainOnce();
+            lock.lock();
+            flushCompleted = target;
+            drained.notify_all();
+            if (stopping) return;
+        }
+    }
+
+    Ring& ringForThread() {
+        thread_local std::shared_ptr<Ring> ring;
+        if (!ring) {
+            ring = std::make_shared<Ring>(RING_CAPACITY);
+            std::lock_guard<std::mutex> lock(registryMtx);
+            rings.push_back(ring);
+        }
+        return *ring;
+    }
+
+    Logger() {
+        const char* env = std::getenv("ATMX_LOG");
+        if (env) setLevel(parseLevel(env, LogLevel::Info));
+        drainer = std::thread(&Logger::drainLoop, this);
+    }
+
+public:
+    static Logger& instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // Call sites are statics that may already be gone; the last pass skips them
+    ~Logger() {
+        {
+            std::lock_guard<std::mutex> lock(registryMtx);
+            sites.clear();
+        }
+        {
+            std::lock_guard<std::mutex> lock(wakeMtx);
+            running = false;
+        }
+        wake.notify_all();
+        if (drainer.joinable()) drainer.join();
+    }
+
+    static LogLevel parseLevel(const std::string& name, LogLevel fallback) {
+        if (name == "debug") return LogLevel::Debug;
+        if (name == "info") return LogLevel::Info;
+        if (name == "warn") return LogLevel::Warn;
+        if (name == "error") return LogLevel::Error;
+        if (name == "off") return LogLevel::Off;
+        return fallback;
+    }
+
+    void setLevel(LogLevel l) { level.store(static_cast<int>(l), std::memory_order_relaxed); }
+    LogLevel getLevel() const { return static_cast<LogLevel>(level.load(std::memory_order_relaxed)); }
+    bool enabled(LogLevel l) const { return static_cast<int>(l) >= level.load(std::memory_order_relaxed); }
+
+    // Repeats of one message per call site per second; 0 (or 65535 and up) disables the limit
+    void setRateLimit(uint32_t perSecond) { limit.store(perSecond ? perSecond : UINT32_MAX, std::memory_order_relaxed); }
+    uint32_t rateLimit() const { return limit.load(std::memory_order_relaxed); }
+
+    void registerSite(LogSite* site) {
+        std::lock_guard<std::mutex> lock(registryMtx);
+        sites.push_back(site);
+    }
+
+    // Hot path: one ring push, no lock
+    void write(LogLevel l, std::string text) {
+        Record r;
+        r.nanos = nowNanos();
+        r.level = l;
+        r.text = std::move(text);
+        if (!ringForThread().push(std::move(r))) dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Blocks until everything logged before the call has been written
+    void flush() {
+        std::unique_lock<std::mutex> lock(wakeMtx);
+        if (!running) return;
+        uint64_t target = ++flushRequested;
+        wake.notify_all();
+        drained.wait(lock, [this, target]() { return flushCompleted >= target; });
+    }
+};
+
+inline LogSite::LogSite(const char* f, int l) : file(f), line(l) {
+    Logger::instance().registerSite(this);
+}
+
+#define ATMX_LOG(level, message)                                                              \
+    do {                                                                                      \
+        static LogSite atmxLogSite(__FILE__, __LINE__);                                       \
+        Logger& atmxLogger = Logger::instance();                                              \
+        if (atmxLogger.enabled(level)) {                                                      \
+            std::ostringstream atmxLogStream;                                                 \
+            atmxLogStream << message;                                                         \
+            std::string atmxLogText = atmxLogStream.str();                                    \
+            if (atmxLogSite.allow(atmxLogger.rateLimit(), atmxLogText)) {                     \
+                atmxLogger.write(level, std::move(atmxLogText));                              \
+            }                                                                                 \
+        }                                                                                     \
+    } while (0)
+
+#if ATMX_LOG_LEVEL <= 0
+#define LOG_DEBUG(message) ATMX_LOG(LogLevel::Debug, message)
+#else
+#define LOG_DEBUG(message) do {} while (0)
+#endif
+
+#if ATMX_LOG_LEVEL <= 1
+#define LOG_INFO(message) ATMX_LOG(LogLevel::Info, message)
+#else
+#define LOG_INFO(message) do {} while (0)
+#endif
+
+#if ATMX_LOG_LEVEL <= 2
+#define LOG_WARN(message) ATMX_LOG(LogLevel::Warn, message)
+#else
+#define LOG_WARN(message) do {} while (0)
+#endif
+
+#if ATMX_LOG_LEVEL <= 3
+#define LOG_ERROR(message) ATMX_LOG(LogLevel::Error, message)
+#else
+#define LOG_ERROR(message) do {} while (0)
+#endif
+
+#endif
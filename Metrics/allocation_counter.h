@@ -0,0 +1,109 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <malloc.h>
+
+// Live / peak heap bytes and allocation counts from a replaced global
+// operator new / delete. Only compiled in with -DATMX_COUNT_ALLOCATIONS (in a
+// benchmark or the server, one translation unit); otherwise enabled() is false
+// and every count reads 0. Sizes are malloc_usable_size, i.e. what malloc
+// really handed out, so they line up with MemoryUsage::chunk() minus headers.
+class AllocationCounter {
+private:
+    static std::atomic<int64_t>& liveBytes() { static std::atomic<int64_t> v{0}; return v; }
+    static std::atomic<int64_t>& peakBytes() { static std::atomic<int64_t> v{0}; return v; }
+    static std::atomic<uint64_t>& allocCount() { static std::atomic<uint64_t> v{0}; return v; }
+    static std::atomic<uint64_t>& freeCount() { static std::atomic<uint64_t> v{0}; return v; }
+
+public:
+    static bool enabled() {
+#ifdef ATMX_COUNT_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static void onAlloc(size_t bytes) {
+        int64_t now = liveBytes().fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed) + bytes;
+        int64_t peak = peakBytes().load(std::memory_order_relaxed);
+        while (now > peak && !peakBytes().compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+        allocCount().fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void onFree(size_t bytes) {
+        liveBytes().fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+        freeCount().fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static int64_t live() { return liveBytes().load(std::memory_order_relaxed); }
+    static int64_t peak() { return peakBytes().load(std::memory_order_relaxed); }
+    static uint64_t allocations() { return allocCount().load(std::memory_order_relaxed); }
+    static uint64_t frees() { return freeCount().load(std::memory_order_relaxed); }
+
+    // Starts a new peak window at the current live size
+    static void resetPeak() { peakBytes().store(live(), std::memory_order_relaxed); }
+};
+
+#ifdef ATMX_COUNT_ALLOCATIONS
+
+inline void* atmxCountedAlloc(size_t size) {
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    AllocationCounter::onAlloc(malloc_usable_size(p));
+    return p;
+}
+
+// Over-aligned types (alignas(64) shards, rings) come through the align_val_t overloads
+inline void* atmxCountedAlignedAlloc(size_t size, std::align_val_t align) {
+    void* p = nullptr;
+    size_t alignment = static_cast<size_t>(align) < sizeof(void*) ? sizeof(void*) : static_cast<size_t>(align);
+    if (posix_memalign(&p, alignment, size ? size : 1) != 0) throw std::bad_alloc();
+    AllocationCounter::onAlloc(malloc_usable_size(p));
+    return p;
+}
+
+inline void atmxCountedFree(void* p) {
+    if (!p) return;
+    AllocationCounter::onFree(malloc_usable_size(p));
+    std::free(p);
+}
+
+void* operator new(size_t size) { return atmxCountedAlloc(size); }
+void* operator new[](size_t size) { return atmxCountedAlloc(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    void* p = std::malloc(size ? size : 1);
+    if (p) AllocationCounter::onAlloc(malloc_usable_size(p));
+    return p;
+}
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+void operator delete(void* p) noexcept { atmxCountedFree(p); }
+void operator delete[](void* p) noexcept { atmxCountedFree(p); }
+void operator delete(void* p, size_t) noexcept { atmxCountedFree(p); }
+void operator delete[](void* p, size_t) noexcept { atmxCountedFree(p); }
+
+void* operator new(size_t size, std::align_val_t align) { return atmxCountedAlignedAlloc(size, align); }
+void* operator new[](size_t size, std::align_val_t align) { return atmxCountedAlignedAlloc(size, align); }
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    try {
+        return atmxCountedAlignedAlloc(size, align);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t& tag) noexcept {
+    return operator new(size, align, tag);
+}
+void operator delete(void* p, std::align_val_t) noexcept { atmxCountedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { atmxCountedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { atmxCountedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { atmxCountedFree(p); }
+
+#endif
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef MEMORY_REPORT_H
+#define MEMORY_REPORT_H
+
+#include "allocation_counter.h"
+#include "../Data_Structures/memory_usage.h"
+#include <cstdio>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+// Named MemoryUsage of each structure, with totals per indexed document (the
+// number hardware is sized by) next to the process RSS and, when compiled in,
+// the counting allocator's live and peak bytes.
+class MemoryReport {
+private:
+    std::vector<std::pair<std::string, MemoryUsage>> parts;
+    size_t documents = 0;
+
+public:
+    static size_t residentBytes() {
+        long pages = 0, resident = 0;
+        FILE* f = std::fopen("/proc/self/statm", "r");
+        if (f) {
+            if (std::fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+            std::fclose(f);
+        }
+        return static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    void add(const std::string& name, const MemoryUsage& usage) { parts.emplace_back(name, usage); }
+    void setDocuments(size_t n) { documents = n; }
+
+    const std::vector<std::pair<std::string, MemoryUsage>>& structures() const { return parts; }
+
+    MemoryUsage total() const {
+        MemoryUsage sum;
+        for (const auto& p : parts) sum += p.second;
+        return sum;
+    }
+
+    double bytesPerDocument() const {
+        return documents ? static_cast<double>(total().total()) / documents : 0.0;
+    }
+
+    std::string json() const {
+        std::ostringstream out;
+        auto usage = [&out](const MemoryUsage& u) {
+            out << "{\"keys\":" << u.keys << ",\"values\":" << u.values << ",\"overhead\":" << u.overhead
+                << ",\"total\":" << u.total() << ",\"entries\":" << u.entries << "}";
+        };
+        out << "{\"structures\":{";
+        for (size_t i = 0; i < parts.size(); ++i) {
+            out << (i ? "," : "") << "\"" << parts[i].first << "\":";
+            usage(parts[i].second);
+        }
+        out << "},\"total\":";
+        usage(total());
+        out << std::fixed << std::setprecision(1) << ",\"documents\":" << documents
+            << ",\"bytes_per_document\":" << bytesPerDocument() << ",\"resident_bytes\":" << residentBytes();
+        if (AllocationCounter::enabled()) {
+            out << ",\"allocator\":{\"live\":" << AllocationCounter::live() << ",\"peak\":" << AllocationCounter::peak()
+                << ",\"allocations\":" << AllocationCounter::allocations() << ",\"frees\":" << AllocationCounter::frees()
+                << "}";
+        }
+        out << "}";
+        return out.str();
+    }
+
+    // One line per structure in MB, for benchmark output
+    void print(std::ostream& os, const char* tag) const {
+        auto mb = [](size_t b) { return b / 1048576.0; };
+        os << std::fixed << std::setprecision(2);
+        for (const auto& p : parts) {
+            const MemoryUsage& u = p.second;
+            os << tag << " " << std::left << std::setw(18) << p.first << std::right << std::setw(10) << mb(u.total())
+               << " MB  (keys " << mb(u.keys) << ", values " << mb(u.values) << ", overhead " << mb(u.overhead)
+               << ", " << u.entries << " entries)\n";
+        }
+        os << tag << " total " << mb(total().total()) << " MB, " << std::setprecision(0) << bytesPerDocument()
+           << " bytes per document, RSS " << std::setprecision(2) << mb(residentBytes()) << " MB";
+        if (AllocationCounter::enabled()) {
+            os << ", heap live " << mb(AllocationCounter::live()) << " MB / peak " << mb(AllocationCounter::peak()) << " MB";
+        }
+        os << "\n";
+        os.unsetf(std::ios::floatfield);
+    }
+};
+
+#endif
@@ -0,0 +1,225 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Counters, gauges and histograms exported at /metrics in the Prometheus text
+// format. Updates are lock-free: every metric is split into cache-line sized
+// shards and each thread bumps its own shard with a relaxed atomic add; only
+// a scrape sums the shards. Registration takes a mutex, so hot paths look a
+// metric up once and keep the reference (function-local statics).
+class MetricShards {
+public:
+    static const int COUNT = 16;
+
+    // Shard of the calling thread, assigned round-robin on first use
+    static int mine() {
+        static std::atomic<int> nextShard{0};
+        thread_local int shard = nextShard.fetch_add(1, std::memory_order_relaxed) % COUNT;
+        return shard;
+    }
+};
+
+class MetricCounter {
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    Shard shards[MetricShards::COUNT];
+
+public:
+    void inc(uint64_t n = 1) { shards[MetricShards::mine()].value.fetch_add(n, std::memory_order_relaxed); }
+
+    uint64_t value() const {
+        uint64_t sum = 0;
+        for (const auto& s : shards) sum += s.value.load(std::memory_order_relaxed);
+        return sum;
+    }
+};
+
+class MetricGauge {
+private:
+    std::atomic<int64_t> current{0};
+
+public:
+    void set(int64_t v) { current.store(v, std::memory_order_relaxed); }
+    void add(int64_t n) { current.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const { return current.load(std::memory_order_relaxed); }
+};
+
+// Cumulative-bucket histogram of seconds; the sum is kept in microseconds
+class MetricHistogram {
+private:
+    struct alignas(64) Shard {
+        std::vector<std::atomic<uint64_t>> buckets;      // Last one is +Inf
+        std::atomic<uint64_t> sumMicros{0};
+        explicit Shard(size_t n) : buckets(n) {}
+    };
+
+    std::vector<double> bounds;
+    std::vector<std::unique_ptr<Shard>> shards;
+
+public:
+    // 1 ms .. 10 s, roughly x2.5 apart
+    static std::vector<double> latencyBounds() {
+        return {0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+    }
+
+    explicit MetricHistogram(std::vector<double> upperBounds = latencyBounds()) : bounds(std::move(upperBounds)) {
+        for (int i = 0; i < MetricShards::COUNT; ++i) shards.emplace_back(new Shard(bounds.size() + 1));
+    }
+
+    void observe(double seconds) {
+        size_t b = 0;
+        while (b < bounds.size() && seconds > bounds[b]) ++b;
+        Shard& s = *shards[MetricShards::mine()];
+        s.buckets[b].fetch_add(1, std::memory_order_relaxed);
+        s.sumMicros.fetch_add(seconds > 0 ? static_cast<uint64_t>(seconds * 1e6) : 0, std::memory_order_relaxed);
+    }
+
+    const std::vector<double>& upperBounds() const { return bounds; }
+
+    // Per-bucket (not cumulative) counts, +Inf last
+    std::vector<uint64_t> counts() const {
+        std::vector<uint64_t> out(bounds.size() + 1, 0);
+        for (const auto& s : shards) {
+            for (size_t b = 0; b < out.size(); ++b) out[b] += s->buckets[b].load(std::memory_order_relaxed);
+        }
+        return out;
+    }
+
+    double sumSeconds() const {
+        uint64_t micros = 0;
+        for (const auto& s : shards) micros += s->sumMicros.load(std::memory_order_relaxed);
+        return micros / 1e6;
+    }
+};
+
+class MetricsRegistry {
+public:
+    enum Type { COUNTER, GAUGE, HISTOGRAM };
+
+private:
+    // One metric name; each label set ("host=\"a\"", or "" for none) is a series
+    struct Family {
+        Type type;
+        std::string help;
+        std::map<std::string, std::unique_ptr<MetricCounter>> counters;
+        std::map<std::string, std::unique_ptr<MetricGauge>> gauges;
+        std::map<std::string, std::unique_ptr<MetricHistogram>> histograms;
+        std::map<std::string, std::function<double()>> callbacks;    // Computed at scrape time
+    };
+
+    std::mutex mtx;
+    std::map<std::string, Family> families;
+
+    Family& family(const std::string& name, Type type, const std::string& help) {
+        auto it = families.find(name);
+        if (it == families.end()) {
+            it = families.emplace(name, Family()).first;
+            it->second.type = type;
+            it->second.help = help;
+        }
+        return it->second;
+    }
+
+    static const char* typeName(Type t) {
+        return t == COUNTER ? "counter" : t == GAUGE ? "gauge" : "histogram";
+    }
+
+    static std::string series(const std::string& name, const std::string& labels, const std::string& extra = "") {
+        std::string all = labels.empty() ? extra : (extra.empty() ? labels : labels + "," + extra);
+        return all.empty() ? name : name + "{" + all + "}";
+    }
+
+    static std::string number(double v) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.10g", v);
+        return buf;
+    }
+
+public:
+    static MetricsRegistry& global() {
+        static MetricsRegistry instance;
+        return instance;
+    }
+
+    // `labels` is the inside of the braces, e.g. "host=\"en.wikipedia.org\""
+    MetricCounter& counter(const std::string& name, const std::string& help, const std::string& labels = "") {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto& slot = family(name, COUNTER, help).counters[labels];
+        if (!slot) slot.reset(new MetricCounter());
+        return *slot;
+    }
+
+    MetricGauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "") {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto& slot = family(name, GAUGE, help).gauges[labels];
+        if (!slot) slot.reset(new MetricGauge());
+        return *slot;
+    }
+
+    MetricHistogram& histogram(const std::string& name, const std::string& help, const std::string& labels = "",
+                               const std::vector<double>& bounds = MetricHistogram::latencyBounds()) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto& slot = family(name, HISTOGRAM, help).histograms[labels];
+        if (!slot) slot.reset(new MetricHistogram(bounds));
+        return *slot;
+    }
+
+    // Value computed on every scrape (index sizes, RSS); replaces an earlier one
+    void callback(const std::string& name, Type type, const std::string& help, std::function<double()> fn,
+                  const std::string& labels = "") {
+        std::lock_guard<std::mutex> lock(mtx);
+        family(name, type, help).callbacks[labels] = std::move(fn);
+    }
+
+    static std::string escapeLabel(const std::string& value) {
+        std::string out;
+        for (char c : value) {
+            if (c == '\\' || c == '"') out += '\\';
+            if (c == '\n') { out += "\\n"; continue; }
+            out += c;
+        }
+        return out;
+    }
+
+    // Text exposition format 0.0.4
+    std::string render() {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::ostringstream out;
+        for (const auto& f : families) {
+            const std::string& name = f.first;
+            const Family& fam = f.second;
+            out << "# HELP " << name << " " << fam.help << "\n# TYPE " << name << " " << typeName(fam.type) << "\n";
+            for (const auto& c : fam.counters) out << series(name, c.first) << " " << c.second->value() << "\n";
+            for (const auto& g : fam.gauges) out << series(name, g.first) << " " << g.second->value() << "\n";
+            for (const auto& cb : fam.callbacks) out << series(name, cb.first) << " " << number(cb.second()) << "\n";
+            for (const auto& h : fam.histograms) {
+                const auto& bounds = h.second->upperBounds();
+                std::vector<uint64_t> counts = h.second->counts();
+                uint64_t cumulative = 0;
+                for (size_t b = 0; b < counts.size(); ++b) {
+                    cumulative += counts[b];
+                    std::string le = b < bounds.size() ? number(bounds[b]) : "+Inf";
+                    out << series(name + "_bucket", h.first, "le=\"" + le + "\"") << " " << cumulative << "\n";
+                }
+                out << series(name + "_sum", h.first) << " " << number(h.second->sumSeconds()) << "\n";
+                out << series(name + "_count", h.first) << " " << cumulative << "\n";
+            }
+        }
+        return out.str();
+    }
+};
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Hardware performance counters (perf_event_open) for the calling thread:
+// cycles, instructions, cache misses, branch misses and page faults, opened as
+// one group so they are read atomically with a single read(). Events the
+// machine or kernel does not allow (VMs without a PMU, perf_event_paranoid)
+// are left out and read as -1 in a Sample. User space only.
+class PerfCounters {
+public:
+    enum Event { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, PAGE_FAULTS, EVENT_COUNT };
+
+    struct Sample {
+        int64_t values[EVENT_COUNT];
+        Sample() { for (auto& v : values) v = -1; }
+    };
+
+    static const char* name(int e) {
+        static const char* names[EVENT_COUNT] = {"cycles", "instructions", "cache_misses", "branch_misses", "page_faults"};
+        return names[e];
+    }
+
+private:
+    int leader = -1;
+    std::vector<int> fds;
+    std::vector<int> order;                  // Group read position -> Event
+
+    static int open(uint32_t type, uint64_t config, int group) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+    }
+
+public:
+    PerfCounters() {
+        const struct { uint32_t type; uint64_t config; } events[EVENT_COUNT] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+        };
+        for (int e = 0; e < EVENT_COUNT; ++e) {
+            int fd = open(events[e].type, events[e].config, leader);
+            if (fd < 0) continue;
+            if (leader < 0) leader = fd;
+            fds.push_back(fd);
+            order.push_back(e);
+        }
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+        for (int fd : fds) ::close(fd);
+    }
+
+    // One set per thread: counters only count the thread that opened them
+    static PerfCounters& forThread() {
+        thread_local PerfCounters counters;
+        return counters;
+    }
+
+    bool available() const { return leader >= 0; }
+    bool has(Event e) const {
+        for (int o : order) if (o == e) return true;
+        return false;
+    }
+
+    // Running totals since the group was opened, scaled up if the kernel multiplexed it
+    bool read(Sample& out) const {
+        if (leader < 0) return false;
+        uint64_t buf[3 + EVENT_COUNT];
+        ssize_t n = ::read(leader, buf, sizeof(buf));
+        if (n < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buf[0] != order.size()) return false;
+        double scale = (buf[2] > 0 && buf[2] < buf[1]) ? static_cast<double>(buf[1]) / buf[2] : 1.0;
+        for (size_t i = 0; i < order.size(); ++i) {
+            out.values[order[i]] = static_cast<int64_t>(buf[3 + i] * scale);
+        }
+        return true;
+    }
+
+    // Events that opened, e.g. "cycles instructions page_faults"
+    std::string describe() const {
+        std::string s;
+        for (int e : order) s += (s.empty() ? "" : " ") + std::string(name(e));
+        return s.empty() ? "none" : s;
+    }
+};
+
+// Named regions accumulating counter deltas across threads. Disabled (a
+// single branch per scope) unless enable() was called, e.g. from ATMX_PERF=1.
+class PerfRegions {
+public:
+    struct Totals {
+        uint64_t calls = 0;
+        uint64_t units = 0;                  // Items processed (candidates scored, ...); calls if not set
+        int64_t values[PerfCounters::EVENT_COUNT] = {0};
+        bool present[PerfCounters::EVENT_COUNT] = {false};
+    };
+
+private:
+    std::mutex mtx;
+    std::unordered_map<std::string, Totals> regions;
+    std::atomic<bool> on{false};
+
+public:
+    static PerfRegions& global() {
+        static PerfRegions instance;
+        return instance;
+    }
+
+    void enable() { on = true; }
+    bool enabled() const { return on; }
+
+    void add(const char* region, const PerfCounters::Sample& before, const PerfCounters::Sample& after,
+             uint64_t units = 1) {
+        std::lock_guard<std::mutex> lock(mtx);
+        Totals& t = regions[region];
+        t.calls++;
+        t.units += units;
+        for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e) {
+            if (before.values[e] < 0 || after.values[e] < 0) continue;
+            t.values[e] += after.values[e] - before.values[e];
+            t.present[e] = true;
+        }
+    }
+
+    std::unordered_map<std::string, Totals> snapshot() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return regions;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mtx);
+        regions.clear();
+    }
+
+    // {"events":"...","regions":{"search":{"calls":n,"cycles":per call,...,"ipc":x}}};
+    // regions that count units also get "units" and a "per_unit" object
+    std::string json() {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1);
+        out << "{\"enabled\":" << (on ? "true" : "false")
+            << ",\"events\":\"" << PerfCounters::forThread().describe() << "\",\"regions\":{";
+        bool first = true;
+        for (const auto& r : snapshot()) {
+            const Totals& t = r.second;
+            out << (first ? "" : ",") << "\"" << r.first << "\":{\"calls\":" << t.calls;
+            first = false;
+            for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e) {
+                if (!t.present[e]) continue;
+                out << ",\"" << PerfCounters::name(e) << "\":" << static_cast<double>(t.values[e]) / t.calls;
+            }
+            if (t.present[PerfCounters::CYCLES] && t.present[PerfCounters::INSTRUCTIONS] && t.values[PerfCounters::CYCLES] > 0) {
+                out << std::setprecision(3) << ",\"ipc\":"
+                    << static_cast<double>(t.values[PerfCounters::INSTRUCTIONS]) / t.values[PerfCounters::CYCLES]
+                    << std::setprecision(1);
+            }
+            if (t.units != t.calls) {
+                out << ",\"units\":" << t.units << ",\"per_unit\":{";
+                bool firstEvent = true;
+                for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e) {
+                    if (!t.present[e]) continue;
+                    out << (firstEvent ? "" : ",") << "\"" << PerfCounters::name(e)
+                        << "\":" << (t.units ? static_cast<double>(t.values[e]) / t.units : 0.0);
+                    firstEvent = false;
+                }
+                out << "}";
+            }
+            out << "}";
+        }
+        out << "}}";
+        return out.str();
+    }
+};
+
+// Counts the enclosing block into a region: PerfScope scope("search.score");
+class PerfScope {
+private:
+    const char* region;
+    bool active;
+    uint64_t units = 1;
+    PerfCounters::Sample before;
+
+public:
+    explicit PerfScope(const char* name) : region(name), active(PerfRegions::global().enabled()) {
+        if (active) active = PerfCounters::forThread().read(before);
+    }
+
+    ~PerfScope() {
+        if (!active) return;
+        PerfCounters::Sample after;
+        if (PerfCounters::forThread().read(after)) PerfRegions::global().add(region, before, after, units);
+    }
+
+    // Items the scope covered, so /api/admin/perf also reports per-item figures
+    void setUnits(uint64_t n) { units = n; }
+};
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef QUERY_TRACE_H
+#define QUERY_TRACE_H
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Wall-clock timings of one /api/search request, stage by stage, plus the work
+// it did (postings touched, candidates scored, bytes serialized). Cheap enough
+// to run on every request: two steady_clock reads per stage.
+class QueryTrace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stage {
+        const char* name;
+        double micros;
+    };
+
+    // Times the enclosing block as one stage: auto timer = trace.stage("score");
+    class Timer {
+    private:
+        QueryTrace& trace;
+        const char* name;
+        Clock::time_point start = Clock::now();
+
+    public:
+        Timer(QueryTrace& t, const char* stageName) : trace(t), name(stageName) {}
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+        Timer(Timer&& other) : trace(other.trace), name(other.name), start(other.start) { other.name = nullptr; }
+
+        ~Timer() {
+            if (name) trace.add(name, std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        }
+    };
+
+private:
+    Clock::time_point begin = Clock::now();
+    double elapsedMs = -1.0;
+    std::vector<Stage> stages;
+
+public:
+    std::string kind;                    // "search" or "suggest"
+    std::string query;
+    size_t postingsTouched = 0;
+    size_t candidatesScored = 0;
+    size_t results = 0;
+    size_t bytesSerialized = 0;
+
+    QueryTrace() { stages.reserve(8); }
+
+    Timer stage(const char* name) { return Timer(*this, name); }
+
+    void add(const char* name, double micros) { stages.push_back({name, micros}); }
+
+    const std::vector<Stage>& getStages() const { return stages; }
+
+    // Stops the request clock; totalMillis() is live until then
+    void finish() { elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count(); }
+
+    double totalMillis() const {
+        if (elapsedMs >= 0) return elapsedMs;
+        return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+
+    // {"total_ms":..,"stages_ms":{"parse":..,...},"postings_touched":..,...}
+    std::string json() const {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3) << "{\"total_ms\":" << totalMillis() << ",\"stages_ms\":{";
+        for (size_t i = 0; i < stages.size(); ++i) {
+            out << (i ? "," : "") << "\"" << stages[i].name << "\":" << stages[i].micros / 1000.0;
+        }
+        out << "},\"postings_touched\":" << postingsTouched << ",\"candidates_scored\":" << candidatesScored
+            << ",\"results\":" << results << ",\"bytes_serialized\":" << bytesSerialized << "}";
+        return out.str();
+    }
+
+    // Query text for a log line: quotes and backslashes escaped, \n \r \t spelled
+    // out and every other control byte as \xHH, so one query is always one line
+    static std::string escapeForLog(const std::string& text) {
+        std::string out;
+        out.reserve(text.size());
+        for (char c : text) {
+            unsigned char u = static_cast<unsigned char>(c);
+            if (c == '\\' || c == '"') {
+                out += '\\';
+                out += c;
+            } else if (c == '\n') {
+                out += "\\n";
+            } else if (c == '\r') {
+                out += "\\r";
+            } else if (c == '\t') {
+                out += "\\t";
+            } else if (u < 0x20 || u == 0x7f) {
+                char hex[5];
+                std::snprintf(hex, sizeof(hex), "\\x%02x", u);
+                out += hex;
+            } else {
+                out += c;
+            }
+        }
+        return out;
+    }
+
+    // One line for the slow-query log: "12.345 ms search "q" parse=0.010 ... postings=..."
+    std::string line() const {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3) << totalMillis() << " ms " << kind << " \""
+            << escapeForLog(query) << "\"";
+        for (const auto& s : stages) out << " " << s.name << "=" << s.micros / 1000.0;
+        out << " postings=" << postingsTouched << " candidates=" << candidatesScored << " results=" << results
+            << " bytes=" << bytesSerialized;
+        return out.str();
+    }
+};
+
+// Appends traces slower than a threshold to a log file, one line each with a
+// local timestamp. A threshold <= 0 disables it.
+class SlowQueryLog {
+private:
+    std::mutex mtx;
+    std::ofstream out;
+    double thresholdMs = 0.0;
+
+public:
+    bool open(const std::string& path, double thresholdMillis) {
+        std::lock_guard<std::mutex> lock(mtx);
+        thresholdMs = thresholdMillis;
+        if (thresholdMs <= 0) return false;
+        out.open(path, std::ios::app);
+        if (!out) {
+            std::cerr << "[SlowLog] Cannot open " << path << "\n";
+            thresholdMs = 0.0;
+            return false;
+        }
+        return true;
+    }
+
+    double threshold() const { return thresholdMs; }
+
+    void record(const QueryTrace& trace) {
+        if (thresholdMs <= 0 || trace.totalMillis() < thresholdMs) return;
+        std::time_t now = std::time(nullptr);
+        std::tm local;
+        localtime_r(&now, &local);
+        char stamp[32];
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+        std::string entry = std::string(stamp) + " " + trace.line() + "\n";
+        std::lock_guard<std::mutex> lock(mtx);
+        out << entry << std::flush;
+    }
+};
+
+#endif
@@ -0,0 +1,286 @@
+#ifndef LOCAL_SOURCE_H
+#define LOCAL_SOURCE_H
+
+#include "page_store.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+// Maps the relative path of a saved HTML file to the URL it was fetched from.
+// URLs come from an optional manifest ("<path> <url>" per line, either order,
+// '#' starts a comment); otherwise the path maps literally, so relative links
+// inside the saved pages ("Other.html", "../index.html") still point at them:
+//
+//   en.wikipedia.org/wiki/Graph.html  ->  https://en.wikipedia.org/wiki/Graph.html
+//   wiki/Graph.html                   ->  <baseUrl>wiki/Graph.html
+//   docs/index.html                   ->  <baseUrl>docs/index.html
+class LocalUrlMapper {
+private:
+    std::unordered_map<std::string, std::string> manifest;
+    std::string baseUrl;
+
+    static std::string normalizePath(std::string path) {
+        std::replace(path.begin(), path.end(), '\\', '/');
+        while (path.compare(0, 2, "./") == 0) path.erase(0, 2);
+        while (!path.empty() && path[0] == '/') path.erase(0, 1);
+        return path;
+    }
+
+    static bool endsWith(const std::string& s, const std::string& suffix) {
+        return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+public:
+    explicit LocalUrlMapper(const std::string& base = "https://en.wikipedia.org/") : baseUrl(base) {
+        if (!baseUrl.empty() && baseUrl.back() != '/') baseUrl += '/';
+    }
+
+    bool loadManifest(const std::string& path) {
+        std::ifstream in(path);
+        if (!in.is_open()) return false;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty() || line[0] == '#') continue;
+            std::istringstream fields(line);
+            std::string a, b;
+            if (!(fields >> a >> b)) continue;
+            if (a.find("://") != std::string::npos) std::swap(a, b);
+            manifest[normalizePath(a)] = b;
+        }
+        return true;
+    }
+
+    size_t manifestSize() const { return manifest.size(); }
+
+    static bool isHtmlPath(const std::string& path) {
+        std::string lower = path;
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        return endsWith(lower, ".html") || endsWith(lower, ".htm") || endsWith(lower, ".xhtml");
+    }
+
+    // Files to ingest: everything in the manifest, else anything that looks like HTML
+    bool wants(const std::string& relPath) const {
+        if (!manifest.empty()) return manifest.count(normalizePath(relPath)) > 0;
+        return isHtmlPath(relPath);
+    }
+
+    // "" if the file has no URL (not in a non-empty manifest)
+    std::string urlFor(const std::string& relPath) const {
+        std::string path = normalizePath(relPath);
+        if (!manifest.empty()) {
+            auto it = manifest.find(path);
+            return it == manifest.end() ? "" : it->second;
+        }
+
+        // A leading host name ("en.wikipedia.org/...") is how most mirroring tools lay out a dump
+        size_t firstSlash = path.find('/');
+        std::string first = path.substr(0, firstSlash);
+        if (firstSlash != std::string::npos && first.find('.') != std::string::npos) {
+            return "https://" + path;
+        }
+        return baseUrl + path;
+    }
+};
+
+// Walks a directory tree (sorted, so runs are reproducible) and yields every
+// wanted file as a page. Only the current file is held in memory.
+class DirectorySource {
+private:
+    std::string root;
+    const LocalUrlMapper& mapper;
+    std::vector<std::string> files;            // Relative paths, in walk order
+    size_t nextFile = 0;
+    uint64_t skipped = 0;
+
+    void collect(const std::string& rel) {
+        std::string dirPath = rel.empty() ? root : root + "/" + rel;
+        DIR* d = ::opendir(dirPath.c_str());
+        if (!d) return;
+        std::vector<std::string> names;
+        while (dirent* e = ::readdir(d)) {
+            std::string name = e->d_name;
+            if (name != "." && name != "..") names.push_back(name);
+        }
+        ::closedir(d);
+        std::sort(names.begin(), names.end());
+
+        for (const auto& name : names) {
+            std::string childRel = rel.empty() ? name : rel + "/" + name;
+            struct stat st;
+            if (::stat((root + "/" + childRel).c_str(), &st) != 0) continue;
+            if (S_ISDIR(st.st_mode)) {
+                collect(childRel);
+            } else if (S_ISREG(st.st_mode)) {
+                if (mapper.wants(childRel)) files.push_back(childRel);
+                else skipped++;
+            }
+        }
+    }
+
+    static bool readFile(const std::string& path, std::string& out) {
+        FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return false;
+        std::fseek(f, 0, SEEK_END);
+        long size = std::ftell(f);
+        std::fseek(f, 0, SEEK_SET);
+        out.resize(size > 0 ? static_cast<size_t>(size) : 0);
+        size_t n = out.empty() ? 0 : std::fread(&out[0], 1, out.size(), f);
+        std::fclose(f);
+        out.resize(n);
+        return true;
+    }
+
+public:
+    DirectorySource(const std::string& directory, const LocalUrlMapper& urlMapper)
+        : root(directory), mapper(urlMapper) {
+        while (root.size() > 1 && root.back() == '/') root.pop_back();
+        collect("");
+    }
+
+    size_t fileCount() const { return files.size(); }
+    uint64_t skippedFiles() const { return skipped; }
+
+    bool next(StoredPage& page) {
+        while (nextFile < files.size()) {
+            const std::string& rel = files[nextFile++];
+            page.url = mapper.urlFor(rel);
+            page.headers.clear();
+            page.date.clear();
+            if (!page.url.empty() && readFile(root + "/" + rel, page.body)) return true;
+            skipped++;
+        }
+        return false;
+    }
+};
+
+// Streams regular files out of a POSIX/GNU tar archive, plain or gzip'ed
+// (zlib's gzread reads both). Long names via GNU 'L' and pax 'path=' records.
+class TarSource {
+private:
+    gzFile file = nullptr;
+    const LocalUrlMapper& mapper;
+    uint64_t skipped = 0;
+
+    static uint64_t parseSize(const unsigned char* field, size_t len) {
+        if (field[0] & 0x80) {                 // GNU base-256 for files >= 8 GiB
+            uint64_t v = field[0] & 0x7f;
+            for (size_t i = 1; i < len; ++i) v = (v << 8) | field[i];
+            return v;
+        }
+        uint64_t v = 0;
+        for (size_t i = 0; i < len && field[i]; ++i) {
+            if (field[i] >= '0' && field[i] <= '7') v = v * 8 + (field[i] - '0');
+        }
+        return v;
+    }
+
+    static std::string field(const unsigned char* p, size_t len) {
+        size_t n = 0;
+        while (n < len && p[n]) ++n;
+        return std::string(reinterpret_cast<const char*>(p), n);
+    }
+
+    bool readExact(std::string& out, uint64_t size) {
+        out.resize(size);
+        size_t done = 0;
+        while (done < size) {
+            unsigned chunk = static_cast<unsigned>(std::min<uint64_t>(size - done, 1u << 30));
+            int n = gzread(file, &out[done], chunk);
+            if (n <= 0) return false;
+            done += static_cast<size_t>(n);
+        }
+        // Entries are padded to the 512-byte block size
+        size_t pad = (512 - size % 512) % 512;
+        char padding[512];
+        return pad == 0 || gzread(file, padding, static_cast<unsigned>(pad)) == static_cast<int>(pad);
+    }
+
+    static std::string paxPath(const std::string& records) {
+        size_t pos = 0;
+        while (pos < records.size()) {
+            size_t space = records.find(' ', pos);
+            if (space == std::string::npos) break;
+            size_t len = std::strtoul(records.c_str() + pos, nullptr, 10);
+            if (len == 0 || pos + len > records.size()) break;
+            std::string kv = records.substr(space + 1, pos + len - space - 2);
+            if (kv.compare(0, 5, "path=") == 0) return kv.substr(5);
+            pos += len;
+        }
+        return "";
+    }
+
+public:
+    TarSource(const std::string& path, const LocalUrlMapper& urlMapper) : mapper(urlMapper) {
+        file = gzopen(path.c_str(), "rb");
+        if (file) gzbuffer(file, 1 << 17);
+    }
+
+    TarSource(const TarSource&) = delete;
+    TarSource& operator=(const TarSource&) = delete;
+
+    ~TarSource() {
+        if (file) gzclose(file);
+    }
+
+    bool isOpen() const { return file != nullptr; }
+    uint64_t skippedFiles() const { return skipped; }
+
+    bool next(StoredPage& page) {
+        if (!file) return false;
+        std::string longName;
+        unsigned char header[512];
+        while (gzread(file, header, 512) == 512) {
+            if (header[0] == 0) return false;  // Two zero blocks end the archive
+
+            std::string name = field(header, 100);
+            std::string prefix = field(header + 345, 155);
+            if (!prefix.empty() && std::string(reinterpret_cast<char*>(header + 257), 5) == "ustar") {
+                name = prefix + "/" + name;
+            }
+            uint64_t size = parseSize(header + 124, 12);
+            char type = static_cast<char>(header[156]);
+
+            std::string data;
+            if (type == 'L' || type == 'x') {
+                if (!readExact(data, size)) return false;
+                longName = (type == 'L') ? field(reinterpret_cast<const unsigned char*>(data.data()), data.size())
+                                         : paxPath(data);
+                continue;
+            }
+            if (!longName.empty()) {
+                name = longName;
+                longName.clear();
+            }
+
+            bool regular = (type == '0' || type == '\0' || type == '7');
+            if (!regular || !mapper.wants(name)) {
+                if (regular) skipped++;
+                if (!readExact(data, size)) return false;
+                continue;
+            }
+            if (!readExact(page.body, size)) return false;
+            page.url = mapper.urlFor(name);
+            page.headers.clear();
+            page.date.clear();
+            if (page.url.empty()) {
+                skipped++;
+                continue;
+            }
+            return true;
+        }
+        return false;
+    }
+};
+
+#endif
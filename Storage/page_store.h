@@ -0,0 +1,266 @@
+#ifndef PAGE_STORE_H
+#define PAGE_STORE_H
+
+#include "../Data_Structures/fingerprint.h"
+#include "../Logger/logger.h"
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <zlib.h>
+
+// One archived HTTP response
+struct StoredPage {
+    std::string url;
+    std::string date;          // WARC-Date, ISO 8601 UTC
+    std::string headers;       // Status line + response headers, "" if none were recorded
+    std::string body;
+};
+
+// Append-only archive of every page the crawler indexed, as WARC/1.0 "response"
+// records with each record compressed as its own gzip member (the usual .warc.gz
+// layout, readable by standard WARC tools). Compression happens in the calling
+// thread; only the final fwrite is serialized.
+class PageStore {
+private:
+    FILE* file = nullptr;
+    int level;
+    std::mutex mtx;
+    std::atomic<uint64_t> records{0};
+    std::atomic<uint64_t> rawBytes{0};
+    std::atomic<uint64_t> storedBytes{0};
+
+    static std::string isoDate(std::time_t t) {
+        char buf[32];
+        std::tm tm;
+        gmtime_r(&t, &tm);
+        std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+        return buf;
+    }
+
+public:
+    explicit PageStore(const std::string& path, int compressionLevel = 6) : level(compressionLevel) {
+        file = std::fopen(path.c_str(), "ab");
+        if (!file) LOG_ERROR("[PageStore] " << path << ": " << std::strerror(errno));
+    }
+
+    PageStore(const PageStore&) = delete;
+    PageStore& operator=(const PageStore&) = delete;
+
+    ~PageStore() {
+        if (file) std::fclose(file);
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+    // gzip (RFC 1952) member of `in`
+    static bool gzipCompress(const std::string& in, std::string& out, int level) {
+        z_stream zs = {};
+        if (deflateInit2(&zs, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+        out.resize(deflateBound(&zs, in.size()) + 32);
+        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+        zs.avail_in = static_cast<uInt>(in.size());
+        zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+        zs.avail_out = static_cast<uInt>(out.size());
+        int rc = deflate(&zs, Z_FINISH);
+        out.resize(zs.total_out);
+        deflateEnd(&zs);
+        return rc == Z_STREAM_END;
+    }
+
+    // `httpHeaders` is the raw status line + headers block (may be empty)
+    bool append(const std::string& url, std::time_t fetchedAt, const std::string& httpHeaders, const std::string& body) {
+        if (!file) return false;
+
+        std::string payload = httpHeaders.empty() ? "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\n" : httpHeaders;
+        while (payload.size() >= 2 && payload.compare(payload.size() - 2, 2, "\r\n") == 0) payload.resize(payload.size() - 2);
+        payload += "\r\n\r\n";
+        payload += body;
+
+        uint64_t seq = records.fetch_add(1);
+        char id[40];
+        std::snprintf(id, sizeof(id), "%016llx%08llx",
+                      static_cast<unsigned long long>(fingerprint64(url)), static_cast<unsigned long long>(seq & 0xffffffff));
+
+        std::string record;
+        record.reserve(payload.size() + url.size() + 256);
+        record += "WARC/1.0\r\n";
+        record += "WARC-Type: response\r\n";
+        record += "WARC-Target-URI: " + url + "\r\n";
+        record += "WARC-Date: " + isoDate(fetchedAt) + "\r\n";
+        record += "WARC-Record-ID: <urn:atmx:" + std::string(id) + ">\r\n";
+        record += "Content-Type: application/http; msgtype=response\r\n";
+        record += "Content-Length: " + std::to_string(payload.size()) + "\r\n\r\n";
+        record += payload;
+        record += "\r\n\r\n";
+
+        std::string compressed;
+        if (!gzipCompress(record, compressed, level)) return false;
+
+        std::lock_guard<std::mutex> lock(mtx);
+        if (std::fwrite(compressed.data(), 1, compressed.size(), file) != compressed.size()) return false;
+        std::fflush(file);
+        rawBytes += record.size();
+        storedBytes += compressed.size();
+        return true;
+    }
+
+    uint64_t recordCount() const { return records; }
+    uint64_t uncompressedBytes() const { return rawBytes; }
+    uint64_t compressedBytes() const { return storedBytes; }
+};
+
+// Sequential reader for WARC files, gzip-per-record (.warc.gz) or plain. Yields
+// "response" records (split into HTTP headers and body) and "resource" records
+// (body only); everything else (warcinfo, request, metadata...) is skipped.
+class PageStoreReader {
+private:
+    FILE* file = nullptr;
+    bool gzipped = false;
+    z_stream zs = {};
+    bool inflating = false;
+    std::string input;         // Compressed bytes not yet consumed by inflate
+    std::string plain;         // Decoded WARC stream
+    size_t pos = 0;
+    uint64_t bytesRead = 0;
+
+    static const size_t CHUNK = 1 << 16;
+
+    // Appends more decoded bytes to `plain`; false at end of file or on corrupt input
+    bool readMore() {
+        if (pos > (1 << 20)) {
+            plain.erase(0, pos);
+            pos = 0;
+        }
+        char buf[CHUNK];
+        if (!gzipped) {
+            size_t n = std::fread(buf, 1, CHUNK, file);
+            bytesRead += n;
+            plain.append(buf, n);
+            return n > 0;
+        }
+
+        // At end of file inflate still runs with no input: it may hold decoded
+        // bytes that did not fit the last output buffer
+        bool atEof = false;
+        if (zs.avail_in == 0) {
+            input.resize(CHUNK);
+            size_t n = std::fread(&input[0], 1, CHUNK, file);
+            bytesRead += n;
+            atEof = n == 0;
+            zs.next_in = reinterpret_cast<Bytef*>(&input[0]);
+            zs.avail_in = static_cast<uInt>(n);
+        }
+        zs.next_out = reinterpret_cast<Bytef*>(buf);
+        zs.avail_out = CHUNK;
+        int rc = inflate(&zs, Z_NO_FLUSH);
+        size_t produced = CHUNK - zs.avail_out;
+        plain.append(buf, produced);
+        if (rc == Z_STREAM_END) {
+            inflateReset(&zs);                   // Next record is the next gzip member
+        } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+            LOG_ERROR("[PageStore] corrupt gzip data (" << rc << ")");
+            return false;
+        }
+        return !atEof || produced > 0;           // Drained: no input and no progress
+    }
+
+    bool readLine(std::string& line) {
+        while (true) {
+            size_t nl = plain.find('\n', pos);
+            if (nl != std::string::npos) {
+                line.assign(plain, pos, nl - pos);
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                pos = nl + 1;
+                return true;
+            }
+            if (!readMore()) return false;
+        }
+    }
+
+    bool readBytes(size_t n, std::string& out) {
+        while (plain.size() - pos < n) {
+            if (!readMore()) return false;
+        }
+        out.assign(plain, pos, n);
+        pos += n;
+        return true;
+    }
+
+public:
+    explicit PageStoreReader(const std::string& path) {
+        file = std::fopen(path.c_str(), "rb");
+        if (!file) return;
+        int c1 = std::fgetc(file), c2 = std::fgetc(file);
+        gzipped = (c1 == 0x1f && c2 == 0x8b);
+        std::rewind(file);
+        if (gzipped) inflating = inflateInit2(&zs, 15 + 32) == Z_OK;
+    }
+
+    PageStoreReader(const PageStoreReader&) = delete;
+    PageStoreReader& operator=(const PageStoreReader&) = delete;
+
+    ~PageStoreReader() {
+        if (inflating) inflateEnd(&zs);
+        if (file) std::fclose(file);
+    }
+
+    bool isOpen() const { return file != nullptr && (!gzipped || inflating); }
+
+    // Compressed (on-disk) bytes consumed so far
+    uint64_t bytesConsumed() const { return bytesRead; }
+
+    bool next(StoredPage& page) {
+        if (!isOpen()) return false;
+        std::string line;
+        while (true) {
+            // Skip the blank lines between records
+            do {
+                if (!readLine(line)) return false;
+            } while (line.empty());
+            if (line.compare(0, 5, "WARC/") != 0) continue;
+
+            std::string type, url, date;
+            size_t length = 0;
+            while (readLine(line) && !line.empty()) {
+                size_t colon = line.find(':');
+                if (colon == std::string::npos) continue;
+                std::string key = line.substr(0, colon);
+                std::string value = line.substr(colon + 1);
+                value.erase(0, value.find_first_not_of(" \t"));
+                for (auto& c : key) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                if (key == "warc-type") type = value;
+                else if (key == "warc-target-uri") url = value;
+                else if (key == "warc-date") date = value;
+                else if (key == "content-length") length = std::strtoull(value.c_str(), nullptr, 10);
+            }
+
+            std::string payload;
+            if (!readBytes(length, payload)) return false;
+            if (type != "response" && type != "resource") continue;
+
+            // Some writers wrap the URI in <>
+            if (url.size() >= 2 && url.front() == '<' && url.back() == '>') url = url.substr(1, url.size() - 2);
+            page.url = url;
+            page.date = date;
+            if (type == "response") {
+                size_t split = payload.find("\r\n\r\n");
+                if (split == std::string::npos) continue;
+                page.headers = payload.substr(0, split + 2);
+                page.body = payload.substr(split + 4);
+            } else {
+                page.headers.clear();
+                page.body = std::move(payload);
+            }
+            return true;
+        }
+    }
+};
+
+#endif
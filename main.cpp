@@ -1,453 +1,505 @@
-#include "Data_Structures/thread_safe_queue.h"
-#include "Data_Structures/hashset.h"
-#include "Crawler/html_downloader.h"
-#include "Crawler/link_parser.h"
-#include "Data_Structures/trie.h"
-#include "Data_Structures/graph.h"
-#include "Indexer/inverted_index.h"
-#include "Data_Structures/hashmap.h"
-#include "Ranker/ranker.h"
-#include "libs/crow_all.h"
-#include "Scraper/scraper.h"
-#include <iostream>
-#include <fstream>
-#include <thread>
-#include <chrono>
-#include <vector>
-#include <sstream>
-#include <algorithm>
-#include <cctype>
-#include <iomanip>
-#include <mutex>
-#include <atomic>
-#include <set>
-#include <cstdlib>
-// ────────────────────────────────────────────────
-//  HELPER FUNCTIONS 
-// ────────────────────────────────────────────────
-
-std::string getDomain(const std::string& url) {
-    size_t pos = url.find("/", 8);
-    return (pos == std::string::npos) ? url : url.substr(0, pos);
-}
-
-bool isHTMLPage(const std::string& url) {
-    std::string lower = url;
-    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-    return lower.find(".css")  == std::string::npos &&
-           lower.find(".js")   == std::string::npos &&
-           lower.find(".png")  == std::string::npos &&
-           lower.find(".jpg")  == std::string::npos &&
-           lower.find(".jpeg") == std::string::npos &&
-           lower.find(".ico")  == std::string::npos &&
-           lower.find(".svg")  == std::string::npos &&
-           lower.find(".gif")  == std::string::npos &&
-           lower.find(".pdf")  == std::string::npos;
-}
-
-
-// ────────────────────────────────────────────────
-//  ROBOTS.TXT HANDLING
-// ────────────────────────────────────────────────
-
-HashMap<std::vector<std::string>> robotsRules;
-
-void fetchRobots(const std::string& domain) {
-    std::string robotsURL = domain + "/robots.txt";
-    std::string content = HTMLDownloader::fetchHTML(robotsURL);
-
-    std::vector<std::string> disallowed;
-    if (!content.empty()) {
-        std::cout << "Fetched robots.txt from " << domain << "\n";
-        std::stringstream ss(content);
-        std::string line;
-        while (std::getline(ss, line)) {
-            if (line.find("Disallow:") == 0) {
-                std::string path = line.substr(9);
-                path.erase(0, path.find_first_not_of(" \t"));
-                path.erase(path.find_last_not_of(" \t\r\n") + 1);
-                if (!path.empty() && path != "/") {
-                    disallowed.push_back(path);
-                }
-            }
-        }
-    } else {
-        std::cout << "No robots.txt or failed to fetch — allowing all paths for " << domain << "\n";
-    }
-    robotsRules[domain] = disallowed;
-}
-
-bool allowedByRobots(const std::string& url) {
-    std::string domain = getDomain(url);
-    if (!robotsRules.contains(domain)) return true;
-
-    std::string path = url.substr(domain.length());
-    if (path.empty()) path = "/";
-
-    const auto& rules = robotsRules.get(domain);
-    for (const auto& rule : rules) {
-        if (path.rfind(rule, 0) == 0) {
-            std::cout << "Blocked by robots.txt: " << url << " (rule: " << rule << ")\n";
-            return false;
-        }
-    }
-    return true;
-}
-
-// ────────────────────────────────────────────────
-//  MAIN
-// ────────────────────────────────────────────────
-
-int main() {
-    std::cout << "Server starting..." << std::endl;
-    std::cout.flush();
-    curl_global_init(CURL_GLOBAL_ALL);
-    std::cout << "Curl initialized" << std::endl;
-    std::cout.flush();
-    std::cout << "Loading index..." << std::endl;
-std::cout.flush();
-
-    ThreadSafeQueue urlQueue;
-    HashSet visitedURLs;
-    HashSet robotsFetchedDomains;
-
-    Trie wordTrie;
-    Graph linkGraph;
-    InvertedIndex invIndex;
-    HashMap<double> pageRanks;
-
-    std::mutex ioMutex;
-    std::atomic<bool> crawling{true};
-    std::atomic<int> processedCount{0};
-
-   // Change this in your main()
-const std::string seedURL = "https://en.wikipedia.org/wiki/Computer_science";
-
-// BEFORE pushing to the queue, sanitize it just in case
- std::string cleanSeed = seedURL;
- size_t s_pos = cleanSeed.find("https://", 8);
-     if (s_pos != std::string::npos) cleanSeed = cleanSeed.substr(s_pos);
-
-    urlQueue.push(cleanSeed);
-    const int MAX_PAGES = 25;
-    const int NUM_WORKERS = 2;
-
-    bool loadedFromDisk = false;
-
-    // Load existing index
-    {
-        std::ifstream in("Indexer/inverted_index.txt");
-        if (in.good()) {
-            std::cout << "Loading existing index from disk...\n";
-            std::string line;
-            while (std::getline(in, line)) {
-                size_t sep = line.find('|');
-                if (sep == std::string::npos) continue;
-                std::string word = line.substr(0, sep);
-                std::string urlsPart = line.substr(sep + 1);
-                std::stringstream ss(urlsPart);
-                std::string urlSeg;
-                while (std::getline(ss, urlSeg, ';')) {
-                    if (!urlSeg.empty()) {
-                        invIndex.add(word, urlSeg);
-                        wordTrie.insert(word);
-                    }
-                }
-            }
-            loadedFromDisk = true;
-            std::cout << "Index loaded successfully." << std::endl;
-            std::cout.flush();
-        }
-    }
-
-    std::ofstream visitedOut("Indexer/visited_pages.txt", std::ios::app);
-
-    if (!loadedFromDisk) {
-
-        urlQueue.push(seedURL);
-
-
-        std::cout << "Starting multi-threaded crawl with " << NUM_WORKERS << " workers...\n";
-        std::cout << "Crawling up to " << MAX_PAGES << " pages from " << seedURL << "\n\n";
-     auto worker = [&]() {
-     while (crawling) {
-        std::string url;
-        if (!urlQueue.try_pop(url)) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            continue;
-        }
-
-        size_t secondProtocol = url.find("https://", 8);
-        if (secondProtocol != std::string::npos) {
-            url = url.substr(secondProtocol);
-        }
-
-        {
-            std::lock_guard<std::mutex> lock(ioMutex);
-            if (visitedURLs.contains(url) || processedCount >= MAX_PAGES) continue;
-            std::cout << "[Worker] Processing: " << url << "\n";
-        }
-
-        std::string html = HTMLDownloader::fetchHTML(url);
-        if (html.empty()) continue;
-
-        // Wikipedia 404 check
-        if (html.find("Wikipedia does not have an article with this exact name") != std::string::npos) {
-            std::lock_guard<std::mutex> lock(ioMutex);
-            std::cout << "[Skipping] Broken Wikipedia link: " << url << "\n";
-            continue; 
-        }
-
-        {
-            std::lock_guard<std::mutex> lock(ioMutex);
-
-            if (visitedURLs.contains(url)) continue;
-            if (processedCount >= MAX_PAGES) {
-                crawling = false;
-                return;
-            }
-
-            visitedURLs.insert(url);
-            visitedOut << url << "\n";
-            processedCount++;
-
-            auto links = extractLinks(html, url);
-            for (auto& link : links) {
-                // Sanitize child links
-                size_t secondChildProto = link.find("https://", 8);
-                if (secondChildProto != std::string::npos) {
-                    link = link.substr(secondChildProto);
-                }
-
-                if (!isHTMLPage(link)) continue;
-                if (link.find("https://en.wikipedia.org/wiki/") != 0) continue;
-                
-                if (link.find("/wiki/Wikipedia:") != std::string::npos ||
-                    link.find("/wiki/Help:")      != std::string::npos ||
-                    link.find("/wiki/Talk:")      != std::string::npos ||
-                    link.find("?")                != std::string::npos) continue;
-
-                if (!visitedURLs.contains(link)) {
-                    linkGraph.addEdge(url, link); 
-                    urlQueue.push(link);
-                }
-            }
-
-            // Inverted Indexing - uses the clean 'url'
-            std::string cleanText = Scraper::extractText(html);
-            std::vector<std::string> words = Scraper::tokenize(cleanText);
-
-            for (const auto& w : words) {
-                invIndex.add(w, url); 
-                wordTrie.insert(w);   
-            }
-            
-            std::cout << "[SUCCESS] Processed (" << processedCount << "/" << MAX_PAGES << "): " << url << "\n";
-        }
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
-    }
-};
-
-        // Launch workers
-        std::vector<std::thread> workers;
-        for (int i = 0; i < NUM_WORKERS; ++i) {
-            workers.emplace_back(worker);
-        }
-
-        // Clean status updates (every 3 seconds)
-        while (crawling && processedCount < MAX_PAGES) {
-        std::this_thread::sleep_for(std::chrono::seconds(3));
-       {
-        std::lock_guard<std::mutex> lock(ioMutex);
-        std::cout << "[Status] Processed: " << processedCount << " / " << MAX_PAGES << "\n";
-       }
-}
-        crawling = false;
-
-        for (auto& t : workers) {
-            if (t.joinable()) t.join();
-        }
-
-        std::cout << "\n=== CRAWLING COMPLETE ===\n";
-        std::cout << "Successfully crawled and indexed " << processedCount << " pages.\n";
-
-        std::cout << "Computing PageRank...\n";
-        pageRanks = Ranker::computePageRank(linkGraph, 40, 0.85);
-
-        std::cout << "Saving inverted index to disk...\n";
-        {
-            std::ofstream out("Indexer/inverted_index.txt");
-            auto allWords = invIndex.getAllWords();
-            for (const auto& word : allWords) {
-                const auto& postings = invIndex.getPostings(word);
-                if (postings.size() == 0) continue;
-                out << word << "|";
-                auto urls = postings.getKeys();
-                for (size_t i = 0; i < urls.size(); ++i) {
-                    out << urls[i];
-                    if (i + 1 < urls.size()) out << ";";
-                }
-                out << "\n";
-            }
-        }
-        std::cout << "Index saved!\n";
-    }
-
-    visitedOut.close();
-
-    // ────────────────────────────────────────────────
-    //  WEB SERVER
-    // ────────────────────────────────────────────────
-
-    std::cout << "\n" << std::string(60, '=') << "\n";
-std::cout << " ATMX SEARCH ENGINE READY!\n";
-std::cout << " Indexed " << invIndex.getDocCount() << " pages\n";
-std::cout << " Visit: http://localhost:8080\n";
-std::cout << std::string(60, '=') << "\n\n";
-
-// Enable CORS globally via middleware
-   // Enable CORS globally
-crow::App<crow::CORSHandler> app;
-
-// Configure CORS properly
-auto& cors = app.get_middleware<crow::CORSHandler>();
-
-cors.global()
-    .origin("*")                  // Allow only your Next.js dev server
-    .methods("GET"_method, "OPTIONS"_method)         // GET for your requests, OPTIONS for preflight
-    .headers("Content-Type", "Accept")                // Allow these common headers
-    .max_age(3600);                                   // Cache preflight for 1 hour (optional but good)
-
-    CROW_ROUTE(app, "/api/search")
-    ([&invIndex, &wordTrie, &pageRanks](const crow::request& req) {
-        crow::response res;
-
-        // No need to handle OPTIONS manually anymore
-        // No need to add Access-Control-Allow-Origin headers manually
-        // The CORS middleware does all of this for you!
-
-        auto q_param = req.url_params.get("q");
-        auto suggest_param = req.url_params.get("suggest");
-
-        crow::json::wvalue result;
-
-        if (suggest_param) {
-    std::string full_input = suggest_param;
-    std::transform(full_input.begin(), full_input.end(), full_input.begin(), ::tolower);
-
-    // 1. Find the last word in the input
-    size_t lastSpace = full_input.find_last_of(" ");
-    std::string prefix;
-    std::string leadText = "";
-
-    if (lastSpace == std::string::npos) {
-        // Only one word typed so far
-        prefix = full_input;
-    } else {
-        // Multiple words: "history tog" -> leadText is "history ", prefix is "tog"
-        leadText = full_input.substr(0, lastSpace + 1);
-        prefix = full_input.substr(lastSpace + 1);
-    }
-
-    crow::json::wvalue::list list;
-    if (!prefix.empty()) {
-        auto suggestions = wordTrie.getSuggestions(prefix, 10);
-        for (const auto& s : suggestions) {
-            // Prepend the leadText so the search bar shows the full phrase
-            list.emplace_back(leadText + s);
-        }
-    }
-    result["suggestions"] = std::move(list);
-}
-        else if (q_param) {
-            std::string query = q_param;
-            std::transform(query.begin(), query.end(), query.begin(), ::tolower);
-
-            std::vector<std::string> terms;
-            std::stringstream qss(query);
-            std::string term;
-            while (qss >> term) {
-                terms.push_back(term);
-            }
-
-            HashSet candidates;
-            for (const auto& t : terms) {
-                auto postings = invIndex.getPostings(t);
-                for (const auto& u : postings.getKeys()) {
-                    candidates.insert(u);
-                }
-            }
-
-            std::vector<Ranker::ScoredDoc> scored;
-            for (const auto& url : candidates.getAll()) {
-                double tfidfSum = 0.0;
-                for (const auto& t : terms) {
-                    tfidfSum += Ranker::computeTFIDF(invIndex, t, url);
-                }
-                double pr = pageRanks.get(url);
-                double score = Ranker::computeFinalScore(tfidfSum, pr, 0.0);
-                if (score > 0.001) {
-                    scored.emplace_back(score, url);
-                }
-            }
-
-            auto top = Ranker::getTopK(scored, 20);
-
-            crow::json::wvalue::list results;
-for (const auto& r : top) {
-    crow::json::wvalue item;
-    
-    // --- START SANITIZER FIX ---
-    std::string finalUrl = r.url;
-    
-    // Check if "https://" appears a second time (starting search after index 8)
-    size_t secondProtocol = finalUrl.find("https://", 8);
-    if (secondProtocol != std::string::npos) {
-        // If doubled, keep only the second part
-        finalUrl = finalUrl.substr(secondProtocol);
-    }
-    // --- END SANITIZER FIX ---
-
-    item["url"] = finalUrl; // Use the cleaned URL
-    item["score"] = r.score;
-
-    // Generate title from the CLEANED URL
-    size_t last = finalUrl.find_last_of('/');
-    std::string title = (last != std::string::npos) ? finalUrl.substr(last + 1) : finalUrl;
-    
-    // Clean up title formatting
-    size_t dotPos = title.find('.');
-    if (dotPos != std::string::npos) title = title.substr(0, dotPos);
-    
-    std::replace(title.begin(), title.end(), '-', ' ');
-    std::replace(title.begin(), title.end(), '_', ' ');
-    if (title.empty()) title = "Untitled Page";
-
-    item["title"] = title;
-    results.emplace_back(std::move(item));
-}
-         result["results"] = std::move(results);
-        }
-        else {
-            result = crow::json::wvalue();  // empty object
-        }
-
-        res.set_header("Content-Type", "application/json");
-        res.body = result.dump();
-
-        return res;
-    });  // Note: removed .methods(...) — not needed when middleware handles OPTIONS
-
-    // Optional: reduce log noise (hide INFO level like favicon requests)
-    app.loglevel(crow::LogLevel::Warning);
-
-
-// Start the server
-const char* port_env = std::getenv("PORT");
-int port = port_env ? std::stoi(port_env) : 8080;
-app.port(port).bindaddr("0.0.0.0").multithreaded().run();
-
-curl_global_cleanup();
-return 0;
+#include "Data_Structures/hashset.h"
+#include "Crawler/html_downloader.h"
+#include "Crawler/crawl_pipeline.h"
+#include "Crawler/link_parser.h"
+#include "Crawler/url_canonicalizer.h"
+#include "Data_Structures/trie.h"
+#include "Data_Structures/graph.h"
+#include "Indexer/inverted_index.h"
+#include "Indexer/bulk_indexer.h"
+#include "Data_Structures/hashmap.h"
+#include "Ranker/ranker.h"
+#include "libs/crow_all.h"
+#include "Scraper/scraper.h"
+#include "Metrics/perf_counters.h"
+#include "Metrics/query_trace.h"
+#include "Metrics/metrics.h"
+#include "Metrics/memory_report.h"
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <mutex>
+#include <atomic>
+#include <set>
+#include <cstdlib>
+// ────────────────────────────────────────────────
+//  MAIN
+// ────────────────────────────────────────────────
+
+int main(int argc, char* argv[]) {
+    std::cout << "Server starting..." << std::endl;
+    std::cout.flush();
+    curl_global_init(CURL_GLOBAL_ALL);
+    std::cout << "Curl initialized" << std::endl;
+    std::cout.flush();
+
+    const char* page_store_env = std::getenv("PAGE_STORE");
+    const std::string pageStorePath = page_store_env ? page_store_env : "Indexer/pages.warc.gz";
+
+    // Offline index builds, no network:
+    //   ./server --reindex [store.warc.gz]                   archived crawl pages
+    //   ./server --ingest <dir|.tar[.gz]|.warc[.gz]> [--manifest file] [--base-url url]
+    const std::string mode = argc > 1 ? argv[1] : "";
+    if (mode == "--reindex" || mode == "--ingest") {
+        Trie trie;
+        Graph graph;
+        InvertedIndex index;
+        UrlFilter linkFilter = UrlFilter::wikipediaDefaults();
+        BulkIndexer::Config bulkConfig;
+        bulkConfig.linkFilter = &linkFilter;
+
+        BulkIndexer::Stats stats;
+        if (mode == "--reindex") {
+            std::string storePath = argc > 2 ? argv[2] : pageStorePath;
+            std::cout << "Reindexing from " << storePath << "...\n";
+            stats = BulkIndexer::reindexStore(storePath, index, trie, graph, bulkConfig);
+        } else {
+            if (argc < 3) {
+                std::cerr << "Usage: " << argv[0] << " --ingest <dir|archive.tar[.gz]|pages.warc[.gz]>"
+                          << " [--manifest file] [--base-url url]\n";
+                curl_global_cleanup();
+                return 1;
+            }
+            std::string manifestPath, baseUrl = "https://en.wikipedia.org/";
+            for (int i = 3; i + 1 < argc; i += 2) {
+                std::string flag = argv[i];
+                if (flag == "--manifest") manifestPath = argv[i + 1];
+                else if (flag == "--base-url") baseUrl = argv[i + 1];
+            }
+            LocalUrlMapper mapper(baseUrl);
+            if (!manifestPath.empty()) {
+                if (!mapper.loadManifest(manifestPath)) {
+                    std::cerr << "Cannot read manifest " << manifestPath << "\n";
+                    curl_global_cleanup();
+                    return 1;
+                }
+                std::cout << "Manifest: " << mapper.manifestSize() << " URLs\n";
+            }
+            std::cout << "Ingesting " << argv[2] << "...\n";
+            stats = BulkIndexer::ingest(argv[2], mapper, index, trie, graph, bulkConfig);
+        }
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << "[BulkIndex] " << stats.pages << " pages (" << stats.duplicates << " duplicates), "
+                  << stats.bytes / 1e6 << " MB in " << stats.seconds << " s: "
+                  << stats.pagesPerSec() << " pages/s, " << stats.mbPerSec() << " MB/s\n";
+        if (stats.pages == 0 || !index.save("Indexer/inverted_index.txt")) {
+            std::cerr << "Bulk indexing failed, existing index left untouched\n";
+            curl_global_cleanup();
+            return 1;
+        }
+        std::cout << "Index saved!\n";
+        curl_global_cleanup();
+        return 0;
+    }
+    std::cout << "Loading index..." << std::endl;
+std::cout.flush();
+
+
+    Trie wordTrie;
+    Graph linkGraph;
+    InvertedIndex invIndex;
+    HashMap<double> pageRanks;
+
+   // Change this in your main()
+const std::string seedURL = "https://en.wikipedia.org/wiki/Computer_science";
+
+// BEFORE pushing to the queue, canonicalize it like every discovered link
+ std::string cleanSeed = UrlCanonicalizer::canonicalize(seedURL).url;
+
+    const int MAX_PAGES = 25;
+
+    bool loadedFromDisk = false;
+
+    // Checkpoints and write-ahead log of a crawl whose index is not saved yet
+    const char* checkpoint_env = std::getenv("CRAWL_CHECKPOINT_DIR");
+    const std::string checkpointDir = checkpoint_env ? checkpoint_env : "Indexer/checkpoint";
+
+    // Load existing index
+    std::ifstream in("Indexer/inverted_index.txt");
+    if (in.good()) {
+        std::cout << "Loading existing index from disk...\n";
+        std::string line;
+        while (std::getline(in, line)) {
+            size_t sep = line.find('|');
+            if (sep == std::string::npos) continue;
+            std::string word = line.substr(0, sep);
+            std::string urlsPart = line.substr(sep + 1);
+            std::stringstream ss(urlsPart);
+            std::string urlSeg;
+            while (std::getline(ss, urlSeg, ';')) {
+                if (!urlSeg.empty()) {
+                    invIndex.add(word, urlSeg);
+                    wordTrie.insert(word);
+                }
+            }
+        }
+        loadedFromDisk = true;
+        std::cout << "Index loaded successfully." << std::endl;
+        std::cout.flush();
+    }
+
+    std::ofstream visitedOut("Indexer/visited_pages.txt", std::ios::app);
+
+    if (!loadedFromDisk) {
+
+        CrawlPipeline::Config crawlConfig;
+        crawlConfig.maxPages = MAX_PAGES;
+        crawlConfig.fetchThreads = 4;
+        crawlConfig.parseThreads = 2;
+        crawlConfig.indexThreads = 1;
+        crawlConfig.politeness.defaultDelay = std::chrono::milliseconds(250);
+        crawlConfig.politeness.maxConnectionsPerHost = 2;
+        // All fetchers share one HTTP/2 multiplexed connection pool per host
+        crawlConfig.fetch.maxConnectionsPerHost = 2;
+        crawlConfig.fetch.maxConcurrentStreams = 100;
+        // Optional rule file overrides the built-in Wikipedia link filter
+        const char* rules_env = std::getenv("URL_FILTER_RULES");
+        if (rules_env && !UrlFilter::loadFile(rules_env, crawlConfig.linkFilter)) {
+            std::cerr << "Could not read URL filter rules from " << rules_env << ", using defaults\n";
+        }
+
+        // Periodic checkpoints of frontier, seen set, graph and index segments
+        crawlConfig.checkpointDir = checkpointDir;
+        crawlConfig.checkpointInterval = std::chrono::seconds(30);
+        // Raw pages are archived so the index can be rebuilt with --reindex
+        crawlConfig.pageStorePath = pageStorePath;
+
+        CrawlPipeline pipeline(crawlConfig, invIndex, wordTrie, linkGraph, visitedOut);
+        // No saved index but a checkpoint or write-ahead log: the last crawl died
+        // before saving, so it is replayed and continued instead of starting over
+        pipeline.resume();
+        pipeline.seed(cleanSeed);
+
+        std::cout << "Starting staged crawl: " << crawlConfig.fetchThreads << " fetch / "
+                  << crawlConfig.parseThreads << " parse / " << crawlConfig.indexThreads << " index threads\n";
+        std::cout << "Crawling up to " << MAX_PAGES << " pages from " << seedURL << "\n\n";
+        pipeline.start();
+
+        // Clean status updates (every 3 seconds); a frontier that ran dry ends the crawl early
+        int idleChecks = 0;
+        while (pipeline.isCrawling() && pipeline.processed() < MAX_PAGES && idleChecks < 2) {
+            std::this_thread::sleep_for(std::chrono::seconds(3));
+            pipeline.printStatus(std::cout);
+            pipeline.checkpointIfDue();
+            idleChecks = pipeline.idle() ? idleChecks + 1 : 0;
+        }
+        pipeline.stop();
+        Logger::instance().flush();
+        pipeline.printStatus(std::cout);
+
+        std::cout << "\n=== CRAWLING COMPLETE ===\n";
+        std::cout << "Successfully crawled and indexed " << pipeline.indexed() << " pages.\n";
+
+        std::cout << "Computing PageRank...\n";
+        pageRanks = Ranker::computePageRank(linkGraph, 40, 0.85);
+
+        std::cout << "Saving inverted index to disk...\n";
+        if (invIndex.save("Indexer/inverted_index.txt")) {
+            std::cout << "Index saved!\n";
+            pipeline.discardCheckpoint();            // A later crawl starts fresh instead of replaying this one
+        } else {
+            std::cerr << "Failed to save the index; the checkpoint in " << checkpointDir
+                      << " is kept and replayed on the next start\n";
+        }
+    }
+
+    visitedOut.close();
+
+    // ────────────────────────────────────────────────
+    //  WEB SERVER
+    // ────────────────────────────────────────────────
+
+    // ATMX_PERF=1 counts cycles / instructions / cache and branch misses / page
+    // faults around the search stages; per-call averages at /api/admin/perf
+    const char* perf_env = std::getenv("ATMX_PERF");
+    if (perf_env && std::string(perf_env) == "1") {
+        PerfRegions::global().enable();
+        std::cout << "[Perf] Counting " << PerfCounters::forThread().describe() << " per search stage\n";
+    }
+
+    // SLOW_QUERY_MS=<ms> logs slower requests with their stage timings to
+    // SLOW_QUERY_LOG (default slow_queries.log)
+    SlowQueryLog slowLog;
+    const char* slow_ms_env = std::getenv("SLOW_QUERY_MS");
+    if (slow_ms_env) {
+        const char* slow_log_env = std::getenv("SLOW_QUERY_LOG");
+        std::string slowPath = slow_log_env ? slow_log_env : "slow_queries.log";
+        if (slowLog.open(slowPath, std::atof(slow_ms_env))) {
+            std::cout << "[SlowLog] Queries over " << slowLog.threshold() << " ms go to " << slowPath << "\n";
+        }
+    }
+
+    // Index sizes and RSS are computed when /metrics is scraped
+    MetricsRegistry& registry = MetricsRegistry::global();
+    registry.callback("atmx_index_terms", MetricsRegistry::GAUGE, "Distinct terms in the inverted index",
+                      [&invIndex]() { return static_cast<double>(invIndex.getTermCount()); });
+    registry.callback("atmx_index_documents", MetricsRegistry::GAUGE, "Documents in the inverted index",
+                      [&invIndex]() { return static_cast<double>(invIndex.getDocCount()); });
+    registry.callback("atmx_index_postings", MetricsRegistry::GAUGE, "(term, document) postings in the inverted index",
+                      [&invIndex]() { return static_cast<double>(invIndex.getPostingCount()); });
+    registry.callback("atmx_graph_nodes", MetricsRegistry::GAUGE, "Pages in the link graph",
+                      [&linkGraph]() { return static_cast<double>(linkGraph.size()); });
+    registry.callback("process_resident_memory_bytes", MetricsRegistry::GAUGE, "Resident set size",
+                      []() { return static_cast<double>(MemoryReport::residentBytes()); });
+
+    // Byte footprint of every structure the server holds. Each one is a full
+    // walk, and nothing changes once the crawl is over, so it is measured once
+    // here; scrapes and /api/admin/memory serve this copy (RSS stays live).
+    MemoryReport memoryReport;
+    memoryReport.add("index.postings", invIndex.postingsMemory());
+    memoryReport.add("index.doc_lengths", invIndex.docLengthMemory());
+    memoryReport.add("trie", wordTrie.memoryUsage());
+    memoryReport.add("graph", linkGraph.memoryUsage());
+    memoryReport.add("pagerank", pageRanks.memoryUsage());
+    memoryReport.setDocuments(invIndex.getDocCount());
+    for (const auto& part : memoryReport.structures()) {
+        double bytes = static_cast<double>(part.second.total());
+        registry.callback("atmx_memory_bytes", MetricsRegistry::GAUGE, "Bytes held by the index structures",
+                          [bytes]() { return bytes; },
+                          "structure=\"" + MetricsRegistry::escapeLabel(part.first) + "\"");
+    }
+
+    // /api/admin/* needs the X-Admin-Token header to match ADMIN_TOKEN; without
+    // ADMIN_TOKEN only loopback clients get in
+    const char* admin_token_env = std::getenv("ADMIN_TOKEN");
+    std::string adminToken = admin_token_env ? admin_token_env : "";
+    auto adminAllowed = [adminToken](const crow::request& req) {
+        if (!adminToken.empty()) return req.get_header_value("X-Admin-Token") == adminToken;
+        const std::string& ip = req.remote_ip_address;
+        return ip == "127.0.0.1" || ip == "::1" || ip == "::ffff:127.0.0.1";
+    };
+    MetricHistogram& searchLatency = registry.histogram("atmx_search_duration_seconds", "/api/search?q= latency");
+    MetricHistogram& suggestLatency = registry.histogram("atmx_suggest_duration_seconds", "/api/search?suggest= latency");
+
+    std::cout << "\n" << std::string(60, '=') << "\n";
+std::cout << " ATMX SEARCH ENGINE READY!\n";
+std::cout << " Indexed " << invIndex.getDocCount() << " pages\n";
+std::cout << " Visit: http://localhost:8080\n";
+std::cout << std::string(60, '=') << "\n\n";
+
+// Enable CORS globally via middleware
+   // Enable CORS globally
+crow::App<crow::CORSHandler> app;
+
+// Configure CORS properly
+auto& cors = app.get_middleware<crow::CORSHandler>();
+
+cors.global()
+    .origin("*")                  // Allow only your Next.js dev server
+    .methods("GET"_method, "OPTIONS"_method)         // GET for your requests, OPTIONS for preflight
+    .headers("Content-Type", "Accept")                // Allow these common headers
+    .max_age(3600);                                   // Cache preflight for 1 hour (optional but good)
+cors.prefix("/api/admin").ignore();                   // Admin data is never readable cross-origin
+
+    CROW_ROUTE(app, "/api/search")
+    ([&invIndex, &wordTrie, &pageRanks, &slowLog, &searchLatency, &suggestLatency](const crow::request& req) {
+        crow::response res;
+
+        // No need to handle OPTIONS manually anymore
+        // No need to add Access-Control-Allow-Origin headers manually
+        // The CORS middleware does all of this for you!
+
+        auto q_param = req.url_params.get("q");
+        auto suggest_param = req.url_params.get("suggest");
+        bool debug = req.url_params.get("debug") && std::string(req.url_params.get("debug")) == "1";
+
+        crow::json::wvalue result;
+        QueryTrace trace;
+
+        if (suggest_param) {
+    trace.kind = "suggest";
+    trace.query = suggest_param;
+    std::string full_input = suggest_param;
+    std::string prefix;
+    std::string leadText = "";
+    {
+        auto timer = trace.stage("parse");
+        std::transform(full_input.begin(), full_input.end(), full_input.begin(), ::tolower);
+
+        // 1. Find the last word in the input
+        size_t lastSpace = full_input.find_last_of(" ");
+
+        if (lastSpace == std::string::npos) {
+            // Only one word typed so far
+            prefix = full_input;
+        } else {
+            // Multiple words: "history tog" -> leadText is "history ", prefix is "tog"
+            leadText = full_input.substr(0, lastSpace + 1);
+            prefix = full_input.substr(lastSpace + 1);
+        }
+    }
+
+    crow::json::wvalue::list list;
+    if (!prefix.empty()) {
+        std::vector<std::string> suggestions;
+        {
+            auto timer = trace.stage("trie");
+            PerfScope perf("suggest.trie");
+            suggestions = wordTrie.getSuggestions(prefix, 10);
+        }
+        for (const auto& s : suggestions) {
+            // Prepend the leadText so the search bar shows the full phrase
+            list.emplace_back(leadText + s);
+        }
+        trace.results = suggestions.size();
+    }
+    result["suggestions"] = std::move(list);
+}
+        else if (q_param) {
+            trace.kind = "search";
+            trace.query = q_param;
+            std::vector<std::string> terms;
+            {
+                auto timer = trace.stage("parse");
+                std::string query = q_param;
+                std::transform(query.begin(), query.end(), query.begin(), ::tolower);
+
+                std::stringstream qss(query);
+                std::string term;
+                while (qss >> term) {
+                    terms.push_back(term);
+                }
+            }
+
+            HashSet candidates;
+            {
+                auto timer = trace.stage("candidates");
+                PerfScope perf("search.candidates");
+                for (const auto& t : terms) {
+                    auto postings = invIndex.getPostings(t);
+                    auto keys = postings.getKeys();
+                    trace.postingsTouched += keys.size();
+                    for (const auto& u : keys) {
+                        candidates.insert(u);
+                    }
+                }
+            }
+
+            std::vector<Ranker::ScoredDoc> scored;
+            {
+                auto timer = trace.stage("score");
+                PerfScope perf("search.score");
+                for (const auto& url : candidates.getAll()) {
+                    double tfidfSum = 0.0;
+                    for (const auto& t : terms) tfidfSum += Ranker::computeTFIDF(invIndex, t, url);
+                    double pr = pageRanks.get(url);
+                    double score = Ranker::computeFinalScore(tfidfSum, pr, 0.0);
+                    if (score > 0.001) {
+                        scored.emplace_back(score, url);
+                    }
+                    trace.candidatesScored++;
+                }
+                perf.setUnits(trace.candidatesScored);
+            }
+
+            std::vector<Ranker::ScoredDoc> top;
+            {
+                auto timer = trace.stage("topk");
+                PerfScope perf("search.topk");
+                top = Ranker::getTopK(scored, 20);
+            }
+            trace.results = top.size();
+
+            crow::json::wvalue::list results;
+            auto titleTimer = trace.stage("titles");
+for (const auto& r : top) {
+    crow::json::wvalue item;
+    
+    // Indexes saved before canonicalization may still hold doubled URLs
+    CanonicalUrl canonical = UrlCanonicalizer::canonicalize(r.url);
+    std::string finalUrl = canonical.valid ? canonical.url : r.url;
+
+    item["url"] = finalUrl; // Use the cleaned URL
+    item["score"] = r.score;
+
+    // Generate title from the CLEANED URL
+    size_t last = finalUrl.find_last_of('/');
+    std::string title = (last != std::string::npos) ? finalUrl.substr(last + 1) : finalUrl;
+    
+    // Clean up title formatting
+    size_t dotPos = title.find('.');
+    if (dotPos != std::string::npos) title = title.substr(0, dotPos);
+    
+    std::replace(title.begin(), title.end(), '-', ' ');
+    std::replace(title.begin(), title.end(), '_', ' ');
+    if (title.empty()) title = "Untitled Page";
+
+    item["title"] = title;
+    results.emplace_back(std::move(item));
+}
+         result["results"] = std::move(results);
+        }
+        else {
+            result = crow::json::wvalue();  // empty object
+        }
+
+        res.set_header("Content-Type", "application/json");
+        {
+            auto timer = trace.stage("dump");
+            res.body = result.dump();
+        }
+        trace.bytesSerialized = res.body.size();
+        trace.finish();
+        slowLog.record(trace);
+        if (suggest_param) suggestLatency.observe(trace.totalMillis() / 1000.0);
+        else if (q_param) searchLatency.observe(trace.totalMillis() / 1000.0);
+
+        // ?debug=1 adds the stage timings as a "debug" member of the response
+        if (debug && !res.body.empty() && res.body.back() == '}') {
+            res.body.pop_back();
+            res.body += std::string(res.body.size() > 1 ? "," : "") + "\"debug\":" + trace.json() + "}";
+        }
+
+        return res;
+    });  // Note: removed .methods(...) — not needed when middleware handles OPTIONS
+
+    // Per-call counter averages of the ATMX_PERF regions; ?reset=1 starts over.
+    // Admin-only like /api/admin/memory, since a reset clears the global counters.
+    CROW_ROUTE(app, "/api/admin/perf")
+    ([&adminAllowed](const crow::request& req) {
+        if (!adminAllowed(req)) return crow::response(403);
+        crow::response res;
+        res.set_header("Content-Type", "application/json");
+        res.body = PerfRegions::global().json();
+        if (req.url_params.get("reset")) PerfRegions::global().reset();
+        return res;
+    });
+
+    // Keys / values / overhead per structure and bytes per indexed document
+    CROW_ROUTE(app, "/api/admin/memory")
+    ([&memoryReport, &adminAllowed](const crow::request& req) {
+        if (!adminAllowed(req)) return crow::response(403);
+        crow::response res;
+        res.set_header("Content-Type", "application/json");
+        res.body = memoryReport.json();
+        return res;
+    });
+
+    // Prometheus scrape target: query, crawl and index series (see Metrics/metrics.h)
+    CROW_ROUTE(app, "/metrics")
+    ([](const crow::request&) {
+        crow::response res;
+        res.set_header("Content-Type", "text/plain; version=0.0.4");
+        res.body = MetricsRegistry::global().render();
+        return res;
+    });
+
+    // Optional: reduce log noise (hide INFO level like favicon requests)
+    app.loglevel(crow::LogLevel::Warning);
+
+
+// Start the server
+const char* port_env = std::getenv("PORT");
+int port = port_env ? std::stoi(port_env) : 8080;
+app.port(port).bindaddr("0.0.0.0").multithreaded().run();
+
+curl_global_cleanup();
+return 0;
 }
\ No newline at end of file